@@ -0,0 +1,255 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include "risc_v_disassembler.h"
+
+// EVERY STAGE REPEATS UNTIL IT RAN THIS LONG
+#define BENCH_MIN_NS        200000000ull
+#define BENCH_SYNTH_SIZE    (1 << 20)
+#define BENCH_MEMO_ENTRIES  4096
+
+typedef struct {
+    char name[32];
+    // .hex TEXT, NULL FOR SYNTHETIC CORPORA
+    const uint8_t *text;
+    size_t text_size;
+    // CODE THE DECODE AND FORMAT STAGES RUN OVER
+    uint8_t *code;
+    size_t size;
+    command_data *cmds;
+    size_t num_of_cmds;
+} bench_corpus;
+
+typedef void (*bench_stage)(bench_corpus *corpus, out_sink *out);
+
+static uint64_t bench_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static uint64_t xorshift64(uint64_t *state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+//================================================================
+//=========================== Stages =============================
+//================================================================
+
+static void stage_parse(bench_corpus *corpus, out_sink *out) {
+    hex_map map;
+    hex_string h_str;
+
+    (void)out;
+    map.data = (*corpus).text;
+    map.size = (*corpus).text_size;
+    map.pos = 0;
+    while (!hex_map_eof(&map)) {
+        if (read_next_str(&h_str, &map) || h_str.flags == 0x01) {
+            break;
+        }
+    }
+}
+
+static void stage_decode(bench_corpus *corpus, out_sink *out) {
+    (void)out;
+    disasm_decode((*corpus).code, (*corpus).size, 0, rv64, (*corpus).cmds, (*corpus).size / 2 + 1, NULL);
+}
+
+static void stage_switch(bench_corpus *corpus, out_sink *out) {
+    command_data cd;
+
+    (void)out;
+    cd.pc = rv64;
+    for (size_t i = 0; i < (*corpus).num_of_cmds; i++) {
+        cd.byte_data = (*corpus).cmds[i].byte_data;
+        bp_opcode(&cd);
+    }
+}
+
+// SAME LOOP AS stage_switch() THROUGH THE GENERATED TABLES
+static void stage_table(bench_corpus *corpus, out_sink *out) {
+    command_data cd;
+
+    (void)out;
+    cd.pc = rv64;
+    for (size_t i = 0; i < (*corpus).num_of_cmds; i++) {
+        cd.byte_data = (*corpus).cmds[i].byte_data;
+        bp_opcode_table(&cd);
+    }
+}
+
+static void stage_format(bench_corpus *corpus, out_sink *out) {
+    (*out).len = 0;
+    disasm_print(out, (*corpus).cmds, (*corpus).num_of_cmds);
+}
+
+// RUN stage UNTIL BENCH_MIN_NS PASSED, PRINT ns PER COMMAND AND MB/s OF bytes
+static void bench_run(bench_corpus *corpus, out_sink *out, const char *stage_name, bench_stage stage,
+    size_t bytes) {
+    uint64_t reps = 0;
+    uint64_t begin = bench_now();
+    uint64_t elapsed;
+
+    do {
+        stage(corpus, out);
+        reps++;
+        elapsed = bench_now() - begin;
+    } while (elapsed < BENCH_MIN_NS);
+
+    double ns = (double)elapsed / reps;
+    printf("%-16s %-8s %10.2f %10.1f\n", (*corpus).name, stage_name,
+        ns / ((*corpus).num_of_cmds ? (*corpus).num_of_cmds : 1), bytes * 1000.0 / ns);
+}
+
+static void bench_corpus_run(bench_corpus *corpus, out_sink *out) {
+    (*corpus).cmds = malloc(((*corpus).size / 2 + 1) * sizeof(command_data));
+    if ((*corpus).cmds == NULL) {
+        return;
+    }
+    (*corpus).num_of_cmds = disasm_decode((*corpus).code, (*corpus).size, 0, rv64, (*corpus).cmds,
+        (*corpus).size / 2 + 1, NULL);
+    if ((*corpus).text != NULL) {
+        bench_run(corpus, out, "parse", stage_parse, (*corpus).text_size);
+    }
+    bench_run(corpus, out, "decode", stage_decode, (*corpus).size);
+    // SAME DECODE THROUGH THE HOT-WORD CACHE, HIT RATE OF 32-BIT WORDS IN ONE PASS FROM A COLD CACHE
+    if (decode_cache_enable(BENCH_MEMO_ENTRIES) == 0) {
+        uint64_t hits;
+        uint64_t misses;
+        stage_decode(corpus, out);
+        decode_cache_stats(&hits, &misses);
+        bench_run(corpus, out, "memo", stage_decode, (*corpus).size);
+        printf("%-16s %-8s %9.1f%%\n", (*corpus).name, "memo hit",
+            (hits + misses) ? hits * 100.0 / (hits + misses) : 0.0);
+        decode_cache_enable(0);
+    }
+    bench_run(corpus, out, "switch", stage_switch, (*corpus).size);
+    bench_run(corpus, out, "table", stage_table, (*corpus).size);
+    bench_run(corpus, out, "format", stage_format, (*corpus).size);
+    free((*corpus).cmds);
+}
+
+//================================================================
+//========================== Corpora =============================
+//================================================================
+
+// THE PART OF THE IMAGE THE LISTING COVERS, FROM THE START ADDRESS TO THE END MARKER
+static uint8_t bench_load_hex(bench_corpus *corpus, hex_map *map, const char *path) {
+    hex_image image;
+    const hex_segment *segment;
+    code_span span;
+
+    memset(corpus, 0, sizeof(*corpus));
+    snprintf((*corpus).name, sizeof((*corpus).name), "%s", path);
+    if (hex_map_open(map, path)) {
+        goto error;
+    }
+    if (hex_image_load(&image, map)) {
+        goto error_free;
+    }
+    if (!image.has_start || (segment = hex_image_find(&image, image.start)) == NULL) {
+        goto error_free;
+    }
+    span.data = (*segment).data;
+    span.size = (*segment).size;
+    span.base = (*segment).base;
+    span.pos = image.start - (*segment).base;
+    span.destruct_flag = 0;
+    span.segment_end = 0;
+    size_t begin = span.pos;
+    size_t end = span.pos;
+    while (get_next_command(&span) != 0) {
+        end = span.pos;
+    }
+    (*corpus).size = end - begin;
+    if (((*corpus).code = malloc((*corpus).size + 1)) == NULL) {
+        goto error_free;
+    }
+    memcpy((*corpus).code, (*segment).data + begin, (*corpus).size);
+    (*corpus).text = (*map).data;
+    (*corpus).text_size = (*map).size;
+    hex_image_free(&image);
+    return 0;
+
+    error_free:
+    hex_image_free(&image);
+    hex_map_close(map);
+    error:
+    return 1;
+}
+
+// RANDOM COMMANDS, rvc_percent OF THEM COMPRESSED
+static uint8_t bench_synth(bench_corpus *corpus, uint8_t rvc_percent) {
+    uint64_t state = 0x9e3779b97f4a7c15ull + rvc_percent;
+
+    memset(corpus, 0, sizeof(*corpus));
+    snprintf((*corpus).name, sizeof((*corpus).name), "random rvc %u%%", rvc_percent);
+    if (((*corpus).code = malloc(BENCH_SYNTH_SIZE + 4)) == NULL) {
+        return 1;
+    }
+    while ((*corpus).size + 4 <= BENCH_SYNTH_SIZE) {
+        uint32_t word = xorshift64(&state);
+        uint8_t *ptr = (*corpus).code + (*corpus).size;
+        if (xorshift64(&state) % 100 < rvc_percent) {
+            if ((word & 0b11) == 0b11) {
+                word ^= 0b01;
+            }
+            ptr[0] = word;
+            ptr[1] = word >> 8;
+            (*corpus).size += 2;
+        } else {
+            word |= 0b11;
+            ptr[0] = word;
+            ptr[1] = word >> 8;
+            ptr[2] = word >> 16;
+            ptr[3] = word >> 24;
+            (*corpus).size += 4;
+        }
+    }
+    return 0;
+}
+
+//================================================================
+//======================= Main Function ==========================
+//================================================================
+
+int main(int argc, char** argv) {
+    static const uint8_t rvc_mix[] = { 0, 50, 100 };
+    bench_corpus corpus;
+    hex_map map;
+    out_sink out;
+
+    disasm_init();
+    if (out_open_mem(&out, 1 << 20)) {
+        printf("ERROR: OUT OF MEMORY\n");
+        return 1;
+    }
+
+    printf("%-16s %-8s %10s %10s\n", "CORPUS", "STAGE", "ns/insn", "MB/s");
+    for (int i = 1; i < argc; i++) {
+        if (bench_load_hex(&corpus, &map, argv[i])) {
+            printf("ERROR: CAN'T LOAD %s\n", argv[i]);
+            continue;
+        }
+        bench_corpus_run(&corpus, &out);
+        free(corpus.code);
+        hex_map_close(&map);
+    }
+    for (size_t i = 0; i < sizeof(rvc_mix); i++) {
+        if (bench_synth(&corpus, rvc_mix[i])) {
+            printf("ERROR: OUT OF MEMORY\n");
+            continue;
+        }
+        bench_corpus_run(&corpus, &out);
+        free(corpus.code);
+    }
+
+    out_close(&out);
+    return 0;
+}
@@ -0,0 +1,324 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include "risc_v_disassembler.h"
+
+//================================================================
+//======================= Main Function ==========================
+//================================================================
+
+static void print_usage(const char *name) {
+    printf("Usage: %s <hex_or_elf_file> [rv32/rv64/rv128] [--check-decoder] [-o <out_file>] [-j <threads>]\n", name);
+    printf("       %s <hex_file/-> <rv32/rv64/rv128> [--raw [--base <address>]] [--check-decoder] [-o <out_file>]\n", name);
+    printf("rv32/rv64/rv128 may be left out for an ELF file, its class picks rv32 or rv64\n");
+    printf("- or a pipe is read as a stream, --raw reads a flat binary loaded at --base (default 0)\n");
+    printf("--start <address> [--end <address>] lists that window of a file instead, without the end marker\n");
+    printf("if --end is given; .hex files get a <hex_file>.idx index so the window is read directly\n");
+    printf("--recursive lists only commands reached from the start by following jumps and branches\n");
+    printf("--cfg <dot/json> writes the basic blocks and edges of those commands instead of the listing\n");
+    printf("--labels puts an L_<address>: line before jump and branch targets and prints targets as labels\n");
+    printf("--pseudo prints pseudo-instructions (li, mv, ret, ...) and auipc pairs as la, call or tail\n");
+    printf("--symbols <elf_or_nm_file> names offsets and call targets by symbol, an ELF input uses its own\n");
+}
+
+// ISA NAMED BY str OR 0xff
+static uint8_t parse_isa(const char *str) {
+    if (strcmp(str, "rv32") == 0) {
+        return rv32;
+    } else if (strcmp(str, "rv64") == 0) {
+        return rv64;
+    } else if (strcmp(str, "rv128") == 0) {
+        return rv128;
+    }
+    return 0xff;
+}
+
+static int disas_stream(int fd, uint8_t raw, uint64_t base, uint8_t pc, uint8_t check_decoder,
+    const char *out_file, const char *name) {
+    uint32_t mismatches = 0;
+    out_sink out;
+
+    if (pc == 0xff) {
+        print_usage(name);
+        goto error;
+    }
+    disasm_init();
+    if (check_decoder) {
+        mismatches = decode_table_check(pc);
+    }
+    fflush(stdout);
+    if ((out_file != NULL) ? out_open_map(&out, out_file) : out_open_fd(&out, STDOUT_FILENO)) {
+        printf("Can't open output file.\n");
+        goto error;
+    }
+    out_puts(&out, "OFFSET\t\tCOMMAND\n");
+    uint32_t stream_mismatches;
+    uint8_t err = disasm_stream(&out, fd, raw, base, pc, check_decoder, &stream_mismatches);
+    mismatches += stream_mismatches;
+    if (out_close(&out)) {
+        printf("ERROR: ERROR WHILE OUTPUT WRITE\n");
+        mismatches++;
+    }
+    if (err) {
+        printf("ERROR: ERROR WHILE FILE READ\n");
+        goto error;
+    }
+    if (fd != STDIN_FILENO) {
+        close(fd);
+    }
+    return (mismatches != 0);
+
+    error:
+    if (fd != STDIN_FILENO) {
+        close(fd);
+    }
+    return 1;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        print_usage(argv[0]);
+        goto error;
+    }
+
+    // RUN THE SWITCH bp_opcode() NEXT TO THE GENERATED TABLE DECODER AND REPORT EVERY DISAGREEMENT
+    uint8_t check_decoder = 0;
+    uint32_t mismatches = 0;
+    const char *out_file = NULL;
+    uint32_t num_of_threads = 1;
+    uint8_t pc = 0xff;
+    uint8_t raw = 0;
+    uint64_t base = 0;
+    uint64_t start_address = 0;
+    uint64_t end_address = UINT64_MAX;
+    uint8_t has_start_address = 0;
+    uint8_t has_end_address = 0;
+    uint8_t recursive = 0;
+    uint8_t notes_flags = 0;
+    const char *symbol_file = NULL;
+    const char *cfg_format = NULL;
+    int first_option = 2;
+    if (argc > 2 && (pc = parse_isa(argv[2])) != 0xff) {
+        first_option = 3;
+    }
+    for (int i = first_option; i < argc; i++) {
+        if (strcmp(argv[i], "--check-decoder") == 0) {
+            check_decoder = 1;
+        } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            out_file = argv[++i];
+        } else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc && atoi(argv[i + 1]) > 0) {
+            num_of_threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--start") == 0 && i + 1 < argc) {
+            start_address = strtoull(argv[++i], NULL, 0);
+            has_start_address = 1;
+        } else if (strcmp(argv[i], "--end") == 0 && i + 1 < argc) {
+            end_address = strtoull(argv[++i], NULL, 0);
+            has_end_address = 1;
+        } else if (strcmp(argv[i], "--cfg") == 0 && i + 1 < argc &&
+            (strcmp(argv[i + 1], "dot") == 0 || strcmp(argv[i + 1], "json") == 0)) {
+            cfg_format = argv[++i];
+        } else if (strcmp(argv[i], "--recursive") == 0) {
+            recursive = 1;
+        } else if (strcmp(argv[i], "--labels") == 0) {
+            notes_flags |= DISASM_LABELS;
+        } else if (strcmp(argv[i], "--pseudo") == 0) {
+            notes_flags |= DISASM_PSEUDO;
+        } else if (strcmp(argv[i], "--symbols") == 0 && i + 1 < argc) {
+            symbol_file = argv[++i];
+        } else if (strcmp(argv[i], "--raw") == 0) {
+            raw = 1;
+        } else if (strcmp(argv[i], "--base") == 0 && i + 1 < argc) {
+            base = strtoull(argv[++i], NULL, 0);
+        } else {
+            print_usage(argv[0]);
+            goto error;
+        }
+    }
+
+    // STDIN, PIPES AND RAW BINARIES ARE DECODED AS THEY ARE READ
+    int fd = STDIN_FILENO;
+    struct stat st;
+    if (strcmp(argv[1], "-") != 0 && (fd = open(argv[1], O_RDONLY)) < 0) {
+        printf("Can't open file.\n");
+        goto error;
+    }
+    if (raw || fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        return disas_stream(fd, raw, base, pc, check_decoder, out_file, argv[0]);
+    }
+    close(fd);
+
+    hex_map input;
+    if (hex_map_open(&input, argv[1])) {
+        printf("Can't open file.\n");
+        goto error;
+    }
+
+    disasm_init();
+
+    // SYMBOLS OF symbol_file, OR OF THE INPUT IF IT IS AN ELF
+    symbol_table symbols;
+    symbol_table_init(&symbols);
+    if (symbol_file != NULL) {
+        hex_map symbol_map;
+        uint8_t err = hex_map_open(&symbol_map, symbol_file);
+        if (!err) {
+            err = elf_detect(&symbol_map) ? symbol_table_load_elf(&symbols, &symbol_map) :
+                symbol_table_load_nm(&symbols, &symbol_map);
+            hex_map_close(&symbol_map);
+        }
+        if (err) {
+            printf("Can't read symbol file.\n");
+            hex_map_close(&input);
+            goto error;
+        }
+    } else if (elf_detect(&input) && symbol_table_load_elf(&symbols, &input)) {
+        printf("ERROR: OUT OF MEMORY\n");
+        hex_map_close(&input);
+        goto error;
+    }
+    symbol_table *notes = (symbols.num_of_entries > 0) ? &symbols : NULL;
+
+    hex_image image;
+    memset(&image, 0, sizeof(image));
+    if (elf_detect(&input)) {
+        uint8_t elf_pc;
+        if (elf_image_load(&image, &input, &elf_pc)) {
+            goto error_while_file_read;
+        }
+        if (pc == 0xff) {
+            pc = elf_pc;
+        }
+    } else {
+        if (pc == 0xff) {
+            symbol_table_free(&symbols);
+            hex_map_close(&input);
+            print_usage(argv[0]);
+            goto error;
+        }
+        if (has_start_address) {
+            // READ ONLY THE WINDOW, ITS LAST COMMAND MAY RUN 2 BYTES PAST end_address
+            hex_index index;
+            if (hex_index_open(&index, &input, argv[1])) {
+                goto error_while_file_read;
+            }
+            uint64_t load_end = (end_address < UINT64_MAX - 2) ? end_address + 2 : UINT64_MAX;
+            uint8_t err = hex_index_load(&index, &input, start_address, load_end, &image);
+            hex_index_free(&index);
+            if (err) {
+                goto error_while_file_read;
+            }
+        } else if (hex_image_load(&image, &input)) {
+            goto error_while_file_read;
+        }
+    }
+    if (has_start_address) {
+        image.start = start_address;
+        image.has_start = 1;
+    }
+    if (has_end_address && end_address <= image.start) {
+        print_usage(argv[0]);
+        goto error_while_file_read;
+    }
+
+    //FIND START OFFSET
+    if (!image.has_start) {
+        goto error_while_file_read;
+    }
+
+    const hex_segment *segment = hex_image_find(&image, image.start);
+    if (segment == NULL) {
+        printf("ERROR: CAN'T FIND OFFSET");
+        goto error_while_file_read;
+    }
+    size_t start = image.start - (*segment).base;
+
+    if (check_decoder) {
+        mismatches = decode_table_check(pc);
+    }
+
+    out_sink out;
+    fflush(stdout);
+    if ((out_file != NULL) ? out_open_map(&out, out_file) : out_open_fd(&out, STDOUT_FILENO)) {
+        printf("Can't open output file.\n");
+        goto error_while_file_read;
+    }
+
+    if (cfg_format == NULL) {
+        out_puts(&out, "OFFSET\t\tCOMMAND\n");
+    }
+
+    if (cfg_format != NULL) {
+        command_data *cmds;
+        size_t num_of_cmds;
+        cfg_graph cfg;
+        uint8_t err = recursive ? disasm_collect_reachable(&image, image.start, pc, &cmds, &num_of_cmds) :
+            disasm_collect_linear(segment, start, has_end_address ? end_address - (*segment).base : (size_t)-1,
+                pc, &cmds, &num_of_cmds);
+        if (err || cfg_build(&cfg, cmds, num_of_cmds)) {
+            printf("ERROR: OUT OF MEMORY\n");
+            mismatches++;
+        } else {
+            if (strcmp(cfg_format, "dot") == 0) {
+                cfg_write_dot(&out, &cfg, cmds);
+            } else {
+                cfg_write_json(&out, &cfg, cmds);
+            }
+            cfg_free(&cfg);
+        }
+        free(cmds);
+    } else if (recursive && (notes_flags != 0 || notes != NULL)) {
+        command_data *cmds;
+        size_t num_of_cmds;
+        uint8_t err = disasm_collect_reachable(&image, image.start, pc, &cmds, &num_of_cmds);
+        if (!err) {
+            mismatches += disasm_print_annotated(&out, cmds, num_of_cmds, check_decoder, notes_flags, notes, &err);
+        }
+        if (err) {
+            printf("ERROR: OUT OF MEMORY\n");
+            mismatches++;
+        }
+        free(cmds);
+    } else if (recursive) {
+        uint8_t err;
+        mismatches += disasm_recursive(&out, &image, image.start, pc, check_decoder, &err);
+        if (err) {
+            printf("ERROR: OUT OF MEMORY\n");
+            mismatches++;
+        }
+    } else if (notes_flags != 0 || notes != NULL) {
+        uint8_t err;
+        mismatches += disasm_annotated(&out, segment, start, has_end_address ? end_address - (*segment).base :
+            (size_t)-1, pc, check_decoder, notes_flags, notes, &err);
+        if (err) {
+            printf("ERROR: OUT OF MEMORY\n");
+            mismatches++;
+        }
+    } else if (has_end_address) {
+        mismatches += disasm_range(&out, segment, start, end_address - (*segment).base, pc, check_decoder);
+    } else if (num_of_threads > 1) {
+        mismatches += disasm_parallel(&out, segment, start, pc, check_decoder, num_of_threads);
+    } else {
+        mismatches += disasm_serial(&out, segment, start, pc, check_decoder);
+    }
+
+    if (out_close(&out)) {
+        printf("ERROR: ERROR WHILE OUTPUT WRITE\n");
+        mismatches++;
+    }
+    hex_image_free(&image);
+    symbol_table_free(&symbols);
+    hex_map_close(&input);
+    return (mismatches != 0);
+
+    error_while_file_read:
+    printf("ERROR: ERROR WHILE FILE READ\n");
+    hex_image_free(&image);
+    symbol_table_free(&symbols);
+    hex_map_close(&input);
+    error:
+    return 1;
+}
@@ -0,0 +1,588 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+// Usage: gen_opcodes <spec_file> <csr_file> <header_out> <table_out>
+// Reads the command list of risc_v_opcodes.spec and the CSR names of risc_v_csrs.list,
+// writes enum rv_op to header_out, opcode_data[], the rv32/rv64/rv128 decode tables
+// and the CSR name table to table_out
+// The tables point at rvc_records[] of risc_v_disassembler.c, filled by disasm_init()
+
+#define SPEC_MAX_OPS        1024
+#define SPEC_FIELD_MAX      32
+#define SPEC_LINE_MAX       256
+#define NUM_OF_ISAS         3
+#define DECODE_SLOTS        64
+#define DECODE_MAX_KEY_BITS 10
+#define DECODE_MAX_BUCKETS  (DECODE_SLOTS << DECODE_MAX_KEY_BITS)
+#define DECODE_MAX_ENTRIES  UINT16_MAX
+#define CSR_NUMBERS         4096
+#define CSR_POOL_MAX        65536
+
+typedef struct {
+    char op[SPEC_FIELD_MAX];
+    char name[SPEC_FIELD_MAX];
+    char codec[SPEC_FIELD_MAX];
+    char format[SPEC_FIELD_MAX];
+    uint32_t mask;
+    uint32_t match;
+    // bit 0 - rv32, 1 - rv64, 2 - rv128, 0 for commands no encoding decodes to
+    uint8_t isa;
+    uint32_t line;
+} spec_entry;
+
+typedef struct {
+    spec_entry entry[SPEC_MAX_OPS];
+    uint32_t num_of_entries;
+    const char *path;
+} spec_list;
+
+// Same layout as rv_decode_slot of risc_v_disassembler.c
+typedef struct {
+    uint8_t shift_lo;
+    uint8_t shift_hi;
+    uint16_t bucket;
+    uint16_t mask_lo;
+    uint16_t mask_hi;
+} gen_slot;
+
+// Candidates entry[first .. first + count) of a bucket, written out as a chain of rv_decode_bucket
+typedef struct {
+    uint16_t first;
+    uint16_t count;
+} gen_bucket;
+
+typedef struct {
+    gen_slot slot[DECODE_SLOTS];
+    gen_bucket bucket[DECODE_MAX_BUCKETS];
+    uint32_t num_of_buckets;
+    // spec entries in decode order, an encoding is in every bucket whose key it doesn't contradict
+    uint16_t entry[DECODE_MAX_ENTRIES];
+    uint32_t num_of_entries;
+    // direct buckets and the chained candidates after them
+    uint32_t num_of_nodes;
+} gen_table;
+
+// Names of csr_name_pool[] one after another, each behind a byte holding its length
+typedef struct {
+    // offset of the length byte of every CSR number, 0 - the empty name at the pool start
+    uint16_t offset[CSR_NUMBERS];
+    char pool[CSR_POOL_MAX];
+    uint32_t pool_size;
+} csr_list;
+
+static const char * const isa_name[NUM_OF_ISAS] = { "rv32", "rv64", "rv128" };
+
+//================================================================
+//========================= Spec Parsing =========================
+//================================================================
+
+// PARSE 0x-PREFIXED HEX str INTO value, 1 IF IT IS NOT ONE
+static uint8_t parse_hex(const char *str, uint32_t *value) {
+    char *end;
+
+    if (str[0] != '0' || (str[1] != 'x' && str[1] != 'X') || str[2] == '\0') {
+        return 1;
+    }
+    unsigned long v = strtoul(str + 2, &end, 16);
+    if (*end != '\0' || v > UINT32_MAX) {
+        return 1;
+    }
+    *value = v;
+    return 0;
+}
+
+// PARSE all OR A COMMA LIST OF 32, 64, 128 INTO isa BITS, 1 IF IT IS NEITHER
+static uint8_t parse_isa(const char *str, uint8_t *isa) {
+    char list[SPEC_FIELD_MAX];
+
+    *isa = 0;
+    if (strcmp(str, "all") == 0) {
+        *isa = (1 << NUM_OF_ISAS) - 1;
+        return 0;
+    }
+    strcpy(list, str);
+    for (char *tok = strtok(list, ","); tok != NULL; tok = strtok(NULL, ",")) {
+        if (strcmp(tok, "32") == 0) {
+            *isa |= 1 << 0;
+        } else if (strcmp(tok, "64") == 0) {
+            *isa |= 1 << 1;
+        } else if (strcmp(tok, "128") == 0) {
+            *isa |= 1 << 2;
+        } else {
+            return 1;
+        }
+    }
+    return (*isa == 0);
+}
+
+static uint8_t spec_read(spec_list *spec, const char *path) {
+    char line[SPEC_LINE_MAX];
+    char mask[SPEC_FIELD_MAX];
+    char match[SPEC_FIELD_MAX];
+    char isa[SPEC_FIELD_MAX];
+    char extra[2];
+    uint32_t line_no = 0;
+    FILE *file;
+
+    (*spec).num_of_entries = 0;
+    (*spec).path = path;
+    if ((file = fopen(path, "r")) == NULL) {
+        fprintf(stderr, "%s: can't open\n", path);
+        return 1;
+    }
+    while (fgets(line, sizeof(line), file) != NULL) {
+        line_no++;
+        if (strchr(line, '\n') == NULL && !feof(file)) {
+            fprintf(stderr, "%s:%u: line too long\n", path, line_no);
+            goto error;
+        }
+        char *hash = strchr(line, '#');
+        if (hash != NULL) {
+            *hash = '\0';
+        }
+        if (strspn(line, " \t\r\n") == strlen(line)) {
+            continue;
+        }
+        if ((*spec).num_of_entries == SPEC_MAX_OPS) {
+            fprintf(stderr, "%s:%u: more than %u commands\n", path, line_no, SPEC_MAX_OPS);
+            goto error;
+        }
+        spec_entry *entry = &(*spec).entry[(*spec).num_of_entries];
+        if (sscanf(line, "%31s %31s %31s %31s %31s %31s %31s %1s", (*entry).op, (*entry).name,
+            (*entry).codec, (*entry).format, mask, match, isa, extra) != 7) {
+            fprintf(stderr, "%s:%u: expected op name codec format mask match isa\n", path, line_no);
+            goto error;
+        }
+        (*entry).line = line_no;
+        (*entry).mask = 0;
+        (*entry).match = 0;
+        (*entry).isa = 0;
+        if (strcmp(mask, "-") == 0 || strcmp(match, "-") == 0 || strcmp(isa, "-") == 0) {
+            if (strcmp(mask, "-") != 0 || strcmp(match, "-") != 0 || strcmp(isa, "-") != 0) {
+                fprintf(stderr, "%s:%u: mask, match and isa must all be - together\n", path, line_no);
+                goto error;
+            }
+        } else if (parse_hex(mask, &(*entry).mask) || parse_hex(match, &(*entry).match)) {
+            fprintf(stderr, "%s:%u: mask and match must be 0x hex numbers\n", path, line_no);
+            goto error;
+        } else if (parse_isa(isa, &(*entry).isa)) {
+            fprintf(stderr, "%s:%u: isa must be all or a list of 32, 64, 128\n", path, line_no);
+            goto error;
+        } else if (((*entry).match & ~(*entry).mask) != 0) {
+            fprintf(stderr, "%s:%u: match has bits outside of mask\n", path, line_no);
+            goto error;
+        } else if (((*entry).mask & 0b11) != 0b11) {
+            fprintf(stderr, "%s:%u: mask must cover the length bits 1:0\n", path, line_no);
+            goto error;
+        }
+        for (uint32_t i = 0; i < (*spec).num_of_entries; i++) {
+            if (strcmp((*spec).entry[i].op, (*entry).op) == 0) {
+                fprintf(stderr, "%s:%u: op %s already on line %u\n", path, line_no, (*entry).op,
+                    (*spec).entry[i].line);
+                goto error;
+            }
+        }
+        (*spec).num_of_entries++;
+    }
+    fclose(file);
+    if ((*spec).num_of_entries == 0 || strcmp((*spec).entry[0].op, "illegal") != 0) {
+        fprintf(stderr, "%s: the first command must be illegal\n", path);
+        return 1;
+    }
+    return 0;
+
+    error:
+    fclose(file);
+    return 1;
+}
+
+// READ "number name" LINES, POOL OFFSET 0 IS THE EMPTY NAME OF UNNAMED CSRS
+static uint8_t csr_read(csr_list *csrs, const char *path) {
+    char line[SPEC_LINE_MAX];
+    char number[SPEC_FIELD_MAX];
+    char name[SPEC_FIELD_MAX];
+    char extra[2];
+    uint32_t line_no = 0;
+    uint32_t csrno;
+    FILE *file;
+
+    memset((*csrs).offset, 0, sizeof((*csrs).offset));
+    (*csrs).pool[0] = 0;
+    (*csrs).pool_size = 1;
+    if ((file = fopen(path, "r")) == NULL) {
+        fprintf(stderr, "%s: can't open\n", path);
+        return 1;
+    }
+    while (fgets(line, sizeof(line), file) != NULL) {
+        line_no++;
+        if (strchr(line, '\n') == NULL && !feof(file)) {
+            fprintf(stderr, "%s:%u: line too long\n", path, line_no);
+            goto error;
+        }
+        char *hash = strchr(line, '#');
+        if (hash != NULL) {
+            *hash = '\0';
+        }
+        if (strspn(line, " \t\r\n") == strlen(line)) {
+            continue;
+        }
+        if (sscanf(line, "%31s %31s %1s", number, name, extra) != 2) {
+            fprintf(stderr, "%s:%u: expected number name\n", path, line_no);
+            goto error;
+        }
+        if (parse_hex(number, &csrno) || csrno >= CSR_NUMBERS) {
+            fprintf(stderr, "%s:%u: number must be 0x hex below 0x%x\n", path, line_no, CSR_NUMBERS);
+            goto error;
+        }
+        if (strspn(name, "abcdefghijklmnopqrstuvwxyz0123456789_.") != strlen(name)) {
+            fprintf(stderr, "%s:%u: name may hold only a-z, 0-9, _ and .\n", path, line_no);
+            goto error;
+        }
+        if ((*csrs).offset[csrno] != 0) {
+            fprintf(stderr, "%s:%u: 0x%03x already named %s\n", path, line_no, csrno,
+                &(*csrs).pool[(*csrs).offset[csrno]]);
+            goto error;
+        }
+        size_t len = strlen(name);
+        if ((*csrs).pool_size + 1 + len > CSR_POOL_MAX) {
+            fprintf(stderr, "%s:%u: names take more than %u bytes\n", path, line_no, CSR_POOL_MAX);
+            goto error;
+        }
+        (*csrs).offset[csrno] = (*csrs).pool_size;
+        (*csrs).pool[(*csrs).pool_size] = len;
+        memcpy(&(*csrs).pool[(*csrs).pool_size + 1], name, len);
+        (*csrs).pool_size += 1 + len;
+    }
+    fclose(file);
+    return 0;
+
+    error:
+    fclose(file);
+    return 1;
+}
+
+//================================================================
+//======================== Decode Tables =========================
+//================================================================
+
+// MUST MATCH decode_slot_index() OF risc_v_disassembler.c
+static uint8_t decode_slot_index(uint32_t byte_data) {
+    uint8_t rvc = ((byte_data & 0b11) << 3) | ((byte_data >> 13) & 0b111);
+    uint8_t major = 32 + ((byte_data >> 2) & 0b11111);
+    // 1 FOR A 32-BIT COMMAND, SO THE INDEX IS PICKED WITHOUT A BRANCH, RVC AND 32-BIT COMMANDS INTERLEAVE
+    uint8_t wide = ((byte_data & 0b11) + 1) >> 2;
+
+    return rvc ^ ((rvc ^ major) & -wide);
+}
+
+// BITS ALREADY FIXED BY THE SLOT ITSELF
+static uint32_t decode_slot_mask(uint8_t slot) {
+    return (slot < 32) ? 0xe003 : 0x7f;
+}
+
+// MUST MATCH decode_bucket_key() OF risc_v_disassembler.c
+static uint32_t decode_bucket_key(const gen_slot *slot, uint32_t byte_data) {
+    return ((byte_data >> (*slot).shift_lo) & (*slot).mask_lo) | ((byte_data >> (*slot).shift_hi) & (*slot).mask_hi);
+}
+
+// BITS OF byte_data THE KEY OF slot LOOKS AT
+static uint32_t decode_key_mask(const gen_slot *slot) {
+    return ((uint32_t)(*slot).mask_lo << (*slot).shift_lo) | ((uint32_t)(*slot).mask_hi << (*slot).shift_hi);
+}
+
+// WORD WITH KEY key OF slot, EVERY OTHER BIT 0
+static uint32_t decode_key_word(const gen_slot *slot, uint32_t key) {
+    return ((key & (*slot).mask_lo) << (*slot).shift_lo) | ((key & (*slot).mask_hi) << (*slot).shift_hi);
+}
+
+// PICK THE TWO LONGEST RUNS OF SET BITS AS SECOND LEVEL KEY, THE LOWER ONE GIVES THE LOW KEY BITS
+// THE RUNS DON'T TOUCH, SO THE HIGHER ONE STARTS PAST THE LENGTH OF THE LOWER ONE AND shift_hi >= 0
+static void decode_slot_key(gen_slot *slot, uint32_t bits) {
+    uint8_t run_shift[2] = {0, 0};
+    uint8_t run_bits[2] = {0, 0};
+    uint8_t i = 0;
+
+    while (i < 32) {
+        if (((bits >> i) & 1) == 0) {
+            i++;
+            continue;
+        }
+        uint8_t start = i;
+        while (i < 32 && ((bits >> i) & 1)) {
+            i++;
+        }
+        uint8_t len = i - start;
+        if (len > run_bits[0]) {
+            run_shift[1] = run_shift[0];
+            run_bits[1] = run_bits[0];
+            run_shift[0] = start;
+            run_bits[0] = len;
+        } else if (len > run_bits[1]) {
+            run_shift[1] = start;
+            run_bits[1] = len;
+        }
+    }
+    if (run_bits[0] > DECODE_MAX_KEY_BITS) {
+        run_bits[0] = DECODE_MAX_KEY_BITS;
+    }
+    if (run_bits[0] + run_bits[1] > DECODE_MAX_KEY_BITS) {
+        run_bits[1] = DECODE_MAX_KEY_BITS - run_bits[0];
+    }
+    uint8_t lo = (run_bits[1] != 0 && run_shift[1] < run_shift[0]) ? 1 : 0;
+    uint8_t hi = 1 - lo;
+    (*slot).shift_lo = run_shift[lo];
+    (*slot).mask_lo = (1u << run_bits[lo]) - 1;
+    (*slot).shift_hi = (run_bits[hi] != 0) ? run_shift[hi] - run_bits[lo] : 0;
+    (*slot).mask_hi = ((1u << run_bits[hi]) - 1) << run_bits[lo];
+}
+
+// TWO ENCODINGS OF ONE WIDTH MAY OVERLAP ONLY IF ONE OF THEM HAS MORE MASK BITS
+static uint8_t decode_check_overlaps(const spec_list *spec, uint8_t isa) {
+    for (uint32_t i = 0; i < (*spec).num_of_entries; i++) {
+        const spec_entry *a = &(*spec).entry[i];
+        if (((*a).isa & (1 << isa)) == 0) {
+            continue;
+        }
+        for (uint32_t j = i + 1; j < (*spec).num_of_entries; j++) {
+            const spec_entry *b = &(*spec).entry[j];
+            if (((*b).isa & (1 << isa)) == 0 || (((*a).match ^ (*b).match) & (*a).mask & (*b).mask) != 0) {
+                continue;
+            }
+            if (__builtin_popcount((*a).mask) == __builtin_popcount((*b).mask)) {
+                fprintf(stderr, "%s:%u: %s overlaps %s of line %u under %s\n", (*spec).path, (*b).line,
+                    (*b).op, (*a).op, (*a).line, isa_name[isa]);
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+// KEY BITS - ANY BIT SOME ENCODING OF THE SLOT TESTS, SO A BUCKET USUALLY HOLDS ONE ENCODING
+static uint8_t decode_table_build(gen_table *table, const spec_list *spec, uint8_t isa) {
+    uint32_t used[DECODE_SLOTS];
+    uint16_t fill[DECODE_MAX_BUCKETS];
+    uint32_t first = 0;
+
+    memset(table, 0, sizeof(*table));
+    if (decode_check_overlaps(spec, isa)) {
+        return 1;
+    }
+    memset(used, 0, sizeof(used));
+    for (uint32_t i = 0; i < (*spec).num_of_entries; i++) {
+        if ((*spec).entry[i].isa & (1 << isa)) {
+            used[decode_slot_index((*spec).entry[i].match)] |= (*spec).entry[i].mask;
+        }
+    }
+
+    for (uint8_t s = 0; s < DECODE_SLOTS; s++) {
+        decode_slot_key(&(*table).slot[s], used[s] & ~decode_slot_mask(s));
+        (*table).slot[s].bucket = (*table).num_of_buckets;
+        (*table).num_of_buckets += ((*table).slot[s].mask_lo | (*table).slot[s].mask_hi) + 1;
+    }
+    if ((*table).num_of_buckets > UINT16_MAX) {
+        fprintf(stderr, "%s: more than %u buckets under %s\n", (*spec).path, UINT16_MAX, isa_name[isa]);
+        return 1;
+    }
+
+    for (uint32_t i = 0; i < (*spec).num_of_entries; i++) {
+        const spec_entry *entry = &(*spec).entry[i];
+        if (((*entry).isa & (1 << isa)) == 0) {
+            continue;
+        }
+        const gen_slot *slot = &(*table).slot[decode_slot_index((*entry).match)];
+        uint32_t tested = (*entry).mask & decode_key_mask(slot);
+        for (uint32_t key = 0; key <= ((*slot).mask_lo | (*slot).mask_hi); key++) {
+            if (((decode_key_word(slot, key) ^ (*entry).match) & tested) == 0) {
+                (*table).bucket[(*slot).bucket + key].count++;
+                (*table).num_of_entries++;
+            }
+        }
+    }
+    if ((*table).num_of_entries > DECODE_MAX_ENTRIES) {
+        fprintf(stderr, "%s: more than %u bucket entries under %s\n", (*spec).path, DECODE_MAX_ENTRIES,
+            isa_name[isa]);
+        return 1;
+    }
+    (*table).num_of_nodes = (*table).num_of_buckets;
+    for (uint32_t b = 0; b < (*table).num_of_buckets; b++) {
+        (*table).bucket[b].first = first;
+        fill[b] = first;
+        first += (*table).bucket[b].count;
+        if ((*table).bucket[b].count > 1) {
+            (*table).num_of_nodes += (*table).bucket[b].count - 1;
+        }
+    }
+    if ((*table).num_of_nodes > UINT16_MAX) {
+        fprintf(stderr, "%s: more than %u chained buckets under %s\n", (*spec).path, UINT16_MAX, isa_name[isa]);
+        return 1;
+    }
+
+    // KEEP MORE SPECIFIC ENCODINGS (c.nop BEFORE c.addi) FIRST IN EVERY BUCKET
+    for (uint32_t i = 0; i < (*spec).num_of_entries; i++) {
+        const spec_entry *entry = &(*spec).entry[i];
+        if (((*entry).isa & (1 << isa)) == 0) {
+            continue;
+        }
+        const gen_slot *slot = &(*table).slot[decode_slot_index((*entry).match)];
+        uint32_t tested = (*entry).mask & decode_key_mask(slot);
+        for (uint32_t key = 0; key <= ((*slot).mask_lo | (*slot).mask_hi); key++) {
+            if (((decode_key_word(slot, key) ^ (*entry).match) & tested) != 0) {
+                continue;
+            }
+            uint32_t b = (*slot).bucket + key;
+            uint16_t pos = fill[b]++;
+            while (pos > (*table).bucket[b].first &&
+                __builtin_popcount((*spec).entry[(*table).entry[pos - 1]].mask) < __builtin_popcount((*entry).mask)) {
+                (*table).entry[pos] = (*table).entry[pos - 1];
+                pos--;
+            }
+            (*table).entry[pos] = i;
+        }
+    }
+    return 0;
+}
+
+//================================================================
+//=========================== Output =============================
+//================================================================
+
+static void write_header(FILE *file, const spec_list *spec) {
+    fprintf(file, "// Generated by gen_opcodes from %s, do not edit\n\n", (*spec).path);
+    fprintf(file, "#ifndef RISC_V_OPCODES_H\n#define RISC_V_OPCODES_H\n\n");
+    fprintf(file, "typedef enum {\n");
+    for (uint32_t i = 0; i < (*spec).num_of_entries; i++) {
+        fprintf(file, "    op_%s%s\n", (*spec).entry[i].op, (i + 1 < (*spec).num_of_entries) ? "," : "");
+    }
+    fprintf(file, "} rv_op;\n\n#endif\n");
+}
+
+static void write_tables(FILE *file, const spec_list *spec, const gen_table *tables, const csr_list *csrs) {
+    fprintf(file, "// Generated by gen_opcodes from %s, do not edit\n\n", (*spec).path);
+
+    fprintf(file, "const rv_opcode_data opcode_data[] = {\n");
+    for (uint32_t i = 0; i < (*spec).num_of_entries; i++) {
+        const spec_entry *entry = &(*spec).entry[i];
+        fprintf(file, "    { \"%s\", rv_codec_%s, rv_fmt_%s }%s // op_%s\n", (*entry).name, (*entry).codec,
+            (*entry).format, (i + 1 < (*spec).num_of_entries) ? "," : "", (*entry).op);
+    }
+    fprintf(file, "};\n");
+
+    for (uint8_t isa = 0; isa < NUM_OF_ISAS; isa++) {
+        const gen_table *table = &tables[isa];
+
+        fprintf(file, "\nstatic const rv_decode_slot decode_slot_%s[DECODE_SLOTS] = {\n", isa_name[isa]);
+        for (uint8_t s = 0; s < DECODE_SLOTS; s++) {
+            const gen_slot *slot = &(*table).slot[s];
+            fprintf(file, "    { %u, %u, %u, 0x%03x, 0x%03x },\n", (*slot).shift_lo, (*slot).shift_hi, (*slot).bucket,
+                (*slot).mask_lo, (*slot).mask_hi);
+        }
+        fprintf(file, "};\n");
+
+        // DIRECT BUCKETS HOLD THE MOST SPECIFIC CANDIDATE, THE REST FOLLOW THEM IN ORDER
+        fprintf(file, "\nstatic const rv_decode_bucket decode_bucket_%s[%u] = {\n", isa_name[isa],
+            (*table).num_of_nodes);
+        uint32_t chain = (*table).num_of_buckets;
+        for (uint32_t b = 0; b < (*table).num_of_buckets; b++) {
+            const gen_bucket *bucket = &(*table).bucket[b];
+            if ((*bucket).count == 0) {
+                fprintf(file, "    { 0x00000000, 0x00000001, op_illegal, 0 },\n");
+                continue;
+            }
+            const spec_entry *entry = &(*spec).entry[(*table).entry[(*bucket).first]];
+            fprintf(file, "    { 0x%08x, 0x%08x, op_%s, %u },\n", (*entry).mask, (*entry).match, (*entry).op,
+                ((*bucket).count > 1) ? chain : 0);
+            chain += ((*bucket).count > 1) ? (*bucket).count - 1 : 0;
+        }
+        chain = (*table).num_of_buckets;
+        for (uint32_t b = 0; b < (*table).num_of_buckets; b++) {
+            const gen_bucket *bucket = &(*table).bucket[b];
+            for (uint16_t i = 1; i < (*bucket).count; i++) {
+                const spec_entry *entry = &(*spec).entry[(*table).entry[(*bucket).first + i]];
+                fprintf(file, "    { 0x%08x, 0x%08x, op_%s, %u },\n", (*entry).mask, (*entry).match, (*entry).op,
+                    (i + 1 < (*bucket).count) ? chain + 1 : 0);
+                chain++;
+            }
+        }
+        fprintf(file, "};\n");
+    }
+
+    fprintf(file, "\nstatic const rv_decode_table decode_tables[%u] = {\n", NUM_OF_ISAS);
+    for (uint8_t isa = 0; isa < NUM_OF_ISAS; isa++) {
+        fprintf(file, "    { decode_slot_%s, decode_bucket_%s, rvc_records[%s] },\n", isa_name[isa],
+            isa_name[isa], isa_name[isa]);
+    }
+    fprintf(file, "};\n");
+
+    // LENGTH BYTE AND NAME AS SEPARATE LITERALS, SO A NAME STARTING WITH A DIGIT DOESN'T EXTEND THE ESCAPE
+    fprintf(file, "\nstatic const char csr_name_pool[%u] =\n    \"\\000\"", (*csrs).pool_size);
+    uint32_t column = 10;
+    for (uint32_t pos = 1; pos < (*csrs).pool_size; pos += 1 + (*csrs).pool[pos]) {
+        uint8_t len = (*csrs).pool[pos];
+        if (column + len + 10 > 100) {
+            fprintf(file, "\n   ");
+            column = 3;
+        }
+        fprintf(file, " \"\\%03o\" \"%.*s\"", len, len, &(*csrs).pool[pos + 1]);
+        column += len + 10;
+    }
+    fprintf(file, ";\n");
+
+    fprintf(file, "\nstatic const uint16_t csr_name_offset[%u] = {", CSR_NUMBERS);
+    for (uint32_t csrno = 0; csrno < CSR_NUMBERS; csrno++) {
+        fprintf(file, "%s%u,", (csrno % 16 == 0) ? "\n    " : " ", (*csrs).offset[csrno]);
+    }
+    fprintf(file, "\n};\n");
+}
+
+// WRITE THE HEADER (tables NULL) OR THE TABLES TO path, REMOVE IT AGAIN IF ANYTHING FAILED
+static uint8_t write_file(const char *path, const spec_list *spec, const gen_table *tables,
+    const csr_list *csrs) {
+    FILE *file;
+
+    if ((file = fopen(path, "w")) == NULL) {
+        fprintf(stderr, "%s: can't create\n", path);
+        return 1;
+    }
+    if (tables == NULL) {
+        write_header(file, spec);
+    } else {
+        write_tables(file, spec, tables, csrs);
+    }
+    if (ferror(file) | fclose(file)) {
+        fprintf(stderr, "%s: write failed\n", path);
+        remove(path);
+        return 1;
+    }
+    return 0;
+}
+
+//================================================================
+//======================= Main Function ==========================
+//================================================================
+
+int main(int argc, char** argv) {
+    static spec_list spec;
+    static gen_table tables[NUM_OF_ISAS];
+    static csr_list csrs;
+
+    if (argc != 5) {
+        fprintf(stderr, "Usage: %s <spec_file> <csr_file> <header_out> <table_out>\n", argv[0]);
+        return 1;
+    }
+    if (spec_read(&spec, argv[1]) || csr_read(&csrs, argv[2])) {
+        return 1;
+    }
+    for (uint8_t isa = 0; isa < NUM_OF_ISAS; isa++) {
+        if (decode_table_build(&tables[isa], &spec, isa)) {
+            return 1;
+        }
+    }
+    if (write_file(argv[3], &spec, NULL, NULL) || write_file(argv[4], &spec, tables, &csrs)) {
+        remove(argv[3]);
+        return 1;
+    }
+    return 0;
+}
@@ -2,6 +2,13 @@
 #include <stdlib.h>
 #include <stdint.h>
 #include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <elf.h>
 #include "risc_v_disassembler.h"
 
 // Type for pointers to functions
@@ -52,6 +59,11 @@ static const char rv_fmt_rd_rs1[]                 = "O\t0,1";
 static const char rv_fmt_rd_rs2[]                 = "O\t0,2";
 static const char rv_fmt_rs1_offset[]             = "O\t1,o";
 static const char rv_fmt_rs2_offset[]             = "O\t2,o";
+// PSEUDO-INSTRUCTIONS ONLY
+static const char rv_fmt_rd_csr[]                 = "O\t0,c";
+static const char rv_fmt_csr_rs1[]                = "O\tc,1";
+static const char rv_fmt_csr_zimm[]               = "O\tc,7";
+static const char rv_fmt_frd_frs1[]               = "O\t3,4";
 
 //================================================================
 //===================== Operand Extractors =======================
@@ -604,1059 +616,3908 @@ static void rv_codec_css_sqsp(command_data* cd) {
 }
 
 //================================================================
-//======================== Opcode Data ===========================
+//================= Opcode Data and Decode Tables ================
 //================================================================
 
-const rv_opcode_data opcode_data[] = {
-    { "illegal", rv_codec_none, rv_fmt_none }, // op_illegal
-    { "addi", rv_codec_ciw_4spn, rv_fmt_rd_rs1_imm }, // op_c_addi4spn
-    { "fld", rv_codec_cl_ld, rv_fmt_frd_offset_rs1}, // op_c_fld
-    { "lq", rv_codec_cl_lq, rv_fmt_rd_offset_rs1 }, // op_c_lq
-    { "lw", rv_codec_cl_lw, rv_fmt_rd_offset_rs1 }, // op_c_lw
-    { "flw", rv_codec_cl_lw, rv_fmt_frd_offset_rs1 }, // op_c_flw
-    { "ld", rv_codec_cl_ld, rv_fmt_rd_offset_rs1 }, // op_c_ld
-    { "fsd", rv_codec_cs_sd, rv_fmt_frs2_offset_rs1 }, // op_c_fsd
-    { "sq", rv_codec_cs_sq, rv_fmt_rs2_offset_rs1 }, // op_c_sq
-    { "sw", rv_codec_cs_sw, rv_fmt_rs2_offset_rs1 }, // op_c_sw
-    { "fsw", rv_codec_cs_sw, rv_fmt_frs2_offset_rs1 }, // op_c_fsw
-    { "sd", rv_codec_cs_sd, rv_fmt_rs2_offset_rs1 }, // op_c_sd
-    { "nop", rv_codec_ci_none, rv_fmt_none }, // op_c_nop
-    { "addi", rv_codec_ci, rv_fmt_rd_rs1_imm }, // op_c_addi
-    { "jal", rv_codec_cj_jal, rv_fmt_rd_offset }, // op_c_jal
-    { "addiw", rv_codec_ci, rv_fmt_rd_rs1_imm }, // op_c_addiw
-    { "addi", rv_codec_ci_li, rv_fmt_rd_rs1_imm }, // op_c_li
-    { "addi", rv_codec_ci_16sp, rv_fmt_rd_rs1_imm }, // op_c_addi16sp
-    { "lui", rv_codec_ci_lui, rv_fmt_rd_imm }, // op_c_lui
-    { "srli", rv_codec_cb_sh6, rv_fmt_rd_rs1_imm }, // op_c_srli
-    { "srai", rv_codec_cb_sh6, rv_fmt_rd_rs1_imm}, // op_c_srai
-    { "andi", rv_codec_cb_imm, rv_fmt_rd_rs1_imm }, // op_c_andi
-    { "sub", rv_codec_cs, rv_fmt_rd_rs1_rs2 }, // op_c_sub
-    { "xor", rv_codec_cs, rv_fmt_rd_rs1_rs2 }, // op_c_xor
-    { "or", rv_codec_cs, rv_fmt_rd_rs1_rs2 }, // op_c_or
-    { "and", rv_codec_cs, rv_fmt_rd_rs1_rs2}, // op_c_and
-    { "subw", rv_codec_cs, rv_fmt_rd_rs1_rs2 }, // op_c_subw
-    { "addw", rv_codec_cs, rv_fmt_rd_rs1_rs2 }, // op_c_addw
-    { "j", rv_codec_cj, rv_fmt_offset }, // op_c_j
-    { "beqz", rv_codec_cb, rv_fmt_rs1_offset}, // op_c_beqz
-    { "bnez", rv_codec_cb, rv_fmt_rs1_offset}, // op_c_bnez
-    { "slli", rv_codec_ci_sh6, rv_fmt_rd_rs1_imm }, // op_c_slli
-    { "fld", rv_codec_ci_ldsp, rv_fmt_frd_offset_rs1 }, // op_c_fldsp
-    { "lq", rv_codec_ci_lqsp, rv_fmt_rd_offset_rs1}, // op_c_lqsp
-    { "lw", rv_codec_ci_lwsp, rv_fmt_rd_offset_rs1}, // op_c_lwsp
-    { "flw", rv_codec_ci_lwsp, rv_fmt_frd_offset_rs1}, // op_c_flwsp
-    { "ld", rv_codec_ci_ldsp, rv_fmt_rd_offset_rs1 }, // op_c_ldsp
-    { "jr", rv_codec_cr_jr, rv_fmt_rs1 }, // op_c_jr
-    { "mv", rv_codec_cr_mv, rv_fmt_rd_rs1 }, // op_c_mv
-    { "ebreak", rv_codec_ci_none, rv_fmt_none }, // op_c_ebreak
-    { "jalr", rv_codec_cr_jalr, rv_fmt_rd_rs1_offset }, // op_c_jalr
-    { "add", rv_codec_cr, rv_fmt_rd_rs1_rs2 }, // op_c_add
-    { "fsd", rv_codec_css_sdsp, rv_fmt_frs2_offset_rs1 }, // op_c_fsdsp
-    { "sq", rv_codec_css_sqsp, rv_fmt_rs2_offset_rs1 }, // op_c_sqsp
-    { "sw", rv_codec_css_swsp, rv_fmt_rs2_offset_rs1 }, // op_c_swsp
-    { "fsw", rv_codec_css_swsp, rv_fmt_frs2_offset_rs1 }, // op_c_fswsp
-    { "sd", rv_codec_css_sdsp, rv_fmt_rs2_offset_rs1 }, // op_c_sdsp // LAST OF COMPRESSED
-    { "lui", rv_codec_u, rv_fmt_rd_imm }, // op_lui
-    { "auipc", rv_codec_u, rv_fmt_rd_offset }, // op_auipc
-    { "jal", rv_codec_uj, rv_fmt_rd_offset }, // op_jal
-    { "jalr", rv_codec_i, rv_fmt_rd_rs1_offset }, // op_jalr
-    { "beq", rv_codec_sb, rv_fmt_rs1_rs2_offset }, // op_beq
-    { "bne", rv_codec_sb, rv_fmt_rs1_rs2_offset }, // op_bne
-    { "blt", rv_codec_sb, rv_fmt_rs1_rs2_offset }, // op_blt
-    { "bge", rv_codec_sb, rv_fmt_rs1_rs2_offset }, // op_bge
-    { "bltu", rv_codec_sb, rv_fmt_rs1_rs2_offset }, // op_bltu
-    { "bgeu", rv_codec_sb, rv_fmt_rs1_rs2_offset }, // op_bgeu
-    { "lb", rv_codec_i, rv_fmt_rd_offset_rs1 }, // op_lb
-    { "lh", rv_codec_i, rv_fmt_rd_offset_rs1 }, // op_lh
-    { "lw", rv_codec_i, rv_fmt_rd_offset_rs1 }, // op_lw
-    { "lbu", rv_codec_i, rv_fmt_rd_offset_rs1 }, // op_lbu
-    { "lhu", rv_codec_i, rv_fmt_rd_offset_rs1 }, // op_lhu
-    { "sb", rv_codec_s, rv_fmt_rs2_offset_rs1 }, // op_sb
-    { "sh", rv_codec_s, rv_fmt_rs2_offset_rs1 }, // op_sh
-    { "sw", rv_codec_s, rv_fmt_rs2_offset_rs1 }, // op_sw
-    { "addi", rv_codec_i, rv_fmt_rd_rs1_imm }, // op_addi
-    { "slti", rv_codec_i, rv_fmt_rd_rs1_imm }, // op_slti
-    { "sltiu", rv_codec_i, rv_fmt_rd_rs1_imm }, // op_sltiu
-    { "xori", rv_codec_i, rv_fmt_rd_rs1_imm }, // op_xori
-    { "ori", rv_codec_i, rv_fmt_rd_rs1_imm }, // op_ori
-    { "andi", rv_codec_i, rv_fmt_rd_rs1_imm }, // op_andi
-    { "slli", rv_codec_i_sh7, rv_fmt_rd_rs1_imm }, // op_slli
-    { "srli", rv_codec_i_sh7, rv_fmt_rd_rs1_imm }, // op_srli
-    { "srai", rv_codec_i_sh7, rv_fmt_rd_rs1_imm }, // op_srai
-    { "add", rv_codec_r, rv_fmt_rd_rs1_rs2 }, // op_add
-    { "sub", rv_codec_r, rv_fmt_rd_rs1_rs2 }, // op_sub
-    { "sll", rv_codec_r, rv_fmt_rd_rs1_rs2 }, // op_sll
-    { "slt", rv_codec_r, rv_fmt_rd_rs1_rs2 }, // op_slt
-    { "sltu", rv_codec_r, rv_fmt_rd_rs1_rs2 }, // op_sltu
-    { "xor", rv_codec_r, rv_fmt_rd_rs1_rs2 }, // op_xor
-    { "srl", rv_codec_r, rv_fmt_rd_rs1_rs2 }, // op_srl
-    { "sra", rv_codec_r, rv_fmt_rd_rs1_rs2 }, // op_sra
-    { "or", rv_codec_r, rv_fmt_rd_rs1_rs2 }, // op_or
-    { "and", rv_codec_r, rv_fmt_rd_rs1_rs2 }, // op_and
-    { "fence", rv_codec_r_f, rv_fmt_pred_succ }, // op_fence
-    { "ecall", rv_codec_none, rv_fmt_none }, // op_ecall
-    { "ebreak", rv_codec_none, rv_fmt_none }, // op_ebreak
-    { "lwu", rv_codec_i, rv_fmt_rd_offset_rs1 }, // op_lwu
-    { "ld", rv_codec_i, rv_fmt_rd_offset_rs1 }, // op_ld
-    { "sd", rv_codec_s, rv_fmt_rs2_offset_rs1 }, // op_sd
-    { "addiw", rv_codec_i, rv_fmt_rd_rs1_imm}, // op_addiw
-    { "slliw", rv_codec_i_sh5, rv_fmt_rd_rs1_imm }, // op_slliw
-    { "srliw", rv_codec_i_sh5, rv_fmt_rd_rs1_imm }, // op_srliw
-    { "sraiw", rv_codec_i_sh5, rv_fmt_rd_rs1_imm }, // op_sraiw
-    { "addw", rv_codec_r, rv_fmt_rd_rs1_rs2 }, // op_addw
-    { "subw", rv_codec_r, rv_fmt_rd_rs1_rs2 }, // op_subw
-    { "sllw", rv_codec_r, rv_fmt_rd_rs1_rs2 }, // op_sllw
-    { "srlw", rv_codec_r, rv_fmt_rd_rs1_rs2 }, // op_srlw
-    { "sraw", rv_codec_r, rv_fmt_rd_rs1_rs2 }, // op_sraw
-    { "fence.i", rv_codec_none, rv_fmt_none }, // op_fence_i
-    { "csrrw", rv_codec_i_csr, rv_fmt_rd_csr_rs1 }, // op_csrrw
-    { "csrrs", rv_codec_i_csr, rv_fmt_rd_csr_rs1 }, // op_csrrs
-    { "csrrc", rv_codec_i_csr, rv_fmt_rd_csr_rs1 }, // op_csrrc
-    { "csrrwi", rv_codec_i_csr, rv_fmt_rd_csr_zimm }, // op_csrrwi
-    { "csrrsi", rv_codec_i_csr, rv_fmt_rd_csr_zimm }, // op_csrrsi
-    { "csrrci", rv_codec_i_csr, rv_fmt_rd_csr_zimm }, // op_csrrci
-    { "mul", rv_codec_r, rv_fmt_rd_rs1_rs2 }, // op_mul
-    { "mulh", rv_codec_r, rv_fmt_rd_rs1_rs2 }, // op_mulh
-    { "mulhsu", rv_codec_r, rv_fmt_rd_rs1_rs2 }, // op_mulhsu
-    { "mulhu", rv_codec_r, rv_fmt_rd_rs1_rs2 }, // op_mulhu
-    { "div", rv_codec_r, rv_fmt_rd_rs1_rs2 }, // op_div
-    { "divu", rv_codec_r, rv_fmt_rd_rs1_rs2 }, // op_divu
-    { "rem", rv_codec_r, rv_fmt_rd_rs1_rs2 }, // op_rem
-    { "remu", rv_codec_r, rv_fmt_rd_rs1_rs2 }, // op_remu
-    { "mulw", rv_codec_r, rv_fmt_rd_rs1_rs2 }, // op_mulw
-    { "divw", rv_codec_r, rv_fmt_rd_rs1_rs2 }, // op_divw
-    { "divuw", rv_codec_r, rv_fmt_rd_rs1_rs2 }, // op_divuw
-    { "remw", rv_codec_r, rv_fmt_rd_rs1_rs2 }, // op_remw
-    { "remuw", rv_codec_r, rv_fmt_rd_rs1_rs2 }, // op_remuw
-    { "lr.w", rv_codec_r_l, rv_fmt_aqrl_rd_rs1 }, // op_lr_w
-    { "sc.w", rv_codec_r_a, rv_fmt_aqrl_rd_rs2_rs1 }, // op_sc_w
-    { "amoswap.w", rv_codec_r_a, rv_fmt_aqrl_rd_rs2_rs1 }, // op_amoswap_w
-    { "amoadd.w", rv_codec_r_a, rv_fmt_aqrl_rd_rs2_rs1 }, // op_amoadd_w
-    { "amoxor.w", rv_codec_r_a, rv_fmt_aqrl_rd_rs2_rs1 }, // op_amoxor_w
-    { "amoand.w", rv_codec_r_a, rv_fmt_aqrl_rd_rs2_rs1 }, // op_amoand_w
-    { "amoor.w", rv_codec_r_a, rv_fmt_aqrl_rd_rs2_rs1 }, // op_amoor_w
-    { "amomin.w", rv_codec_r_a, rv_fmt_aqrl_rd_rs2_rs1 }, // op_amomin_w
-    { "amomax.w", rv_codec_r_a, rv_fmt_aqrl_rd_rs2_rs1 }, // op_amomax_w
-    { "amominu.w", rv_codec_r_a, rv_fmt_aqrl_rd_rs2_rs1 }, // op_amominu_w
-    { "amomaxu.w", rv_codec_r_a, rv_fmt_aqrl_rd_rs2_rs1 }, // op_amomaxu_w
-    { "lr.d", rv_codec_r_l, rv_fmt_aqrl_rd_rs1 }, // op_lr_d
-    { "sc.d", rv_codec_r_a, rv_fmt_aqrl_rd_rs2_rs1 }, // op_sc_d
-    { "amoswap.d", rv_codec_r_a, rv_fmt_aqrl_rd_rs2_rs1 }, // op_amoswap_d
-    { "amoadd.d", rv_codec_r_a, rv_fmt_aqrl_rd_rs2_rs1 }, // op_amoadd_d
-    { "amoxor.d", rv_codec_r_a, rv_fmt_aqrl_rd_rs2_rs1 }, // op_amoxor_d
-    { "amoand.d", rv_codec_r_a, rv_fmt_aqrl_rd_rs2_rs1 }, // op_amoand_d
-    { "amoor.d", rv_codec_r_a, rv_fmt_aqrl_rd_rs2_rs1 }, // op_amoor_d
-    { "amomin.d", rv_codec_r_a, rv_fmt_aqrl_rd_rs2_rs1 }, // op_amomin_d
-    { "amomax.d", rv_codec_r_a, rv_fmt_aqrl_rd_rs2_rs1 }, // op_amomax_d
-    { "amominu.d", rv_codec_r_a, rv_fmt_aqrl_rd_rs2_rs1 }, // op_amominu_d
-    { "amomaxu.d", rv_codec_r_a, rv_fmt_aqrl_rd_rs2_rs1 }, // op_amomaxu_d
-    { "flw", rv_codec_i, rv_fmt_frd_offset_rs1 }, // op_flw
-    { "fsw", rv_codec_s, rv_fmt_frs2_offset_rs1 }, // op_fsw
-    { "fmadd.s", rv_codec_r4_m, rv_fmt_rm_frd_frs1_frs2_frs3 }, // op_fmadd_s
-    { "fmsum.s", rv_codec_r4_m, rv_fmt_rm_frd_frs1_frs2_frs3 }, // op_fmsub_s
-    { "fnmsub.s", rv_codec_r4_m, rv_fmt_rm_frd_frs1_frs2_frs3 }, // op_fnmsub_s
-    { "fnmadd.s", rv_codec_r4_m, rv_fmt_rm_frd_frs1_frs2_frs3 }, // op_fnmadd_s
-    { "fadd.s", rv_codec_r_m, rv_fmt_rm_frd_frs1_frs2 }, // op_fadd_s
-    { "fsub.s", rv_codec_r_m, rv_fmt_rm_frd_frs1_frs2 }, // op_fsub_s
-    { "fmul.s", rv_codec_r_m, rv_fmt_rm_frd_frs1_frs2 }, // op_fmul_s
-    { "fdiv.s", rv_codec_r_m, rv_fmt_rm_frd_frs1_frs2 }, // op_fdiv_s
-    { "fsqrt.s", rv_codec_r_m, rv_fmt_rm_frd_frs1 }, // op_fsqrt_s
-    { "fsgnj.s", rv_codec_r, rv_fmt_frd_frs1_frs2 }, // op_fsgnj_s
-    { "fsgnjn.s", rv_codec_r, rv_fmt_frd_frs1_frs2 }, // op_fsgnjn_s
-    { "fsgnjx.s", rv_codec_r, rv_fmt_frd_frs1_frs2 }, // op_fsgnjx_s
-    { "fmin.s", rv_codec_r, rv_fmt_frd_frs1_frs2 }, // op_fmin_s
-    { "fmax.s", rv_codec_r, rv_fmt_frd_frs1_frs2 }, // op_fmax_s
-    { "fcvt.w.s", rv_codec_r_m, rv_fmt_rm_rd_frs1 }, // op_fcvt_w_s
-    { "fcvt.wu.s", rv_codec_r_m, rv_fmt_rm_rd_frs1 }, // op_fcvt_wu_s
-    { "fmv.x.w", rv_codec_r, rv_fmt_rd_frs1 }, // op_fmv_x_w
-    { "feq.s", rv_codec_r, rv_fmt_rd_frs1_frs2 }, // op_feq_s
-    { "flt.s", rv_codec_r, rv_fmt_rd_frs1_frs2 }, // op_flt_s
-    { "fle.s", rv_codec_r, rv_fmt_rd_frs1_frs2 }, // op_fle_s
-    { "fclass.s", rv_codec_r, rv_fmt_rd_frs1 }, // op_fclass_s
-    { "fcvt.s.w", rv_codec_r_m, rv_fmt_rm_frd_rs1 }, // op_fcvt_s_w
-    { "fcvt.s.wu", rv_codec_r_m, rv_fmt_rm_frd_rs1 }, // op_fcvt_s_wu
-    { "fmv.w.x", rv_codec_r, rv_fmt_frd_rs1 }, // op_fmv_w_x
-    { "fcvt.l.s", rv_codec_r_m, rv_fmt_rm_rd_frs1 }, // op_fcvt_l_s
-    { "fcvt.lu.s", rv_codec_r_m, rv_fmt_rm_rd_frs1 }, // op_fcvt_lu_s
-    { "fcvt.s.l", rv_codec_r_m, rv_fmt_rm_frd_rs1 }, // op_fcvt_s_l
-    { "fcvt.s.lu", rv_codec_r_m, rv_fmt_rm_frd_rs1 }, // op_fcvt_s_lu
-    { "fld", rv_codec_i, rv_fmt_frd_offset_rs1 }, // op_fld
-    { "fsd", rv_codec_s, rv_fmt_frs2_offset_rs1 }, // op_fsd
-    { "fmadd.d", rv_codec_r4_m, rv_fmt_rm_frd_frs1_frs2_frs3 }, // op_fmadd_d
-    { "fmsub.d", rv_codec_r4_m, rv_fmt_rm_frd_frs1_frs2_frs3}, // op_fmsub_d
-    { "fnmsub.d", rv_codec_r4_m, rv_fmt_rm_frd_frs1_frs2_frs3}, // op_fnmsub_d
-    { "fnmadd.d", rv_codec_r4_m, rv_fmt_rm_frd_frs1_frs2_frs3}, // op_fnmadd_d
-    { "fadd.d", rv_codec_r_m, rv_fmt_rm_frd_frs1_frs2 }, // op_fadd_d
-    { "fsub.d", rv_codec_r_m, rv_fmt_rm_frd_frs1_frs2 }, // op_fsub_d
-    { "fmul.d", rv_codec_r_m, rv_fmt_rm_frd_frs1_frs2 }, // op_fmul_d
-    { "fdiv.d", rv_codec_r_m, rv_fmt_rm_frd_frs1_frs2 }, // op_fdiv_d
-    { "fsqrt.d", rv_codec_r_m, rv_fmt_rm_frd_frs1 }, // op_fsqrt_d
-    { "fsgnj.d", rv_codec_r, rv_fmt_frd_frs1_frs2 }, // op_fsgnj_d
-    { "fsgnjn.d", rv_codec_r, rv_fmt_frd_frs1_frs2 }, // op_fsgnjn_d
-    { "fsgnjx.d", rv_codec_r, rv_fmt_frd_frs1_frs2 }, // op_fsgnjx_d
-    { "fmin.d", rv_codec_r, rv_fmt_frd_frs1_frs2 }, // op_fmin_d
-    { "fmax.d", rv_codec_r, rv_fmt_frd_frs1_frs2 }, // op_fmax_d
-    { "fcvt.s.d", rv_codec_r_m, rv_fmt_rm_frd_frs1 }, // op_fcvt_s_d
-    { "fcvt.d.s", rv_codec_r_m, rv_fmt_rm_frd_frs1 }, // op_fcvt_d_s
-    { "feq.d", rv_codec_r, rv_fmt_rd_frs1_frs2 }, // op_feq_d
-    { "flt.d", rv_codec_r, rv_fmt_rd_frs1_frs2 }, // op_flt_d
-    { "fle.d", rv_codec_r, rv_fmt_rd_frs1_frs2 }, // op_fle_d
-    { "fclass.d", rv_codec_r, rv_fmt_rd_frs1 }, // op_fclass_d
-    { "fcvt.w.d", rv_codec_r_m, rv_fmt_rm_rd_frs1 }, // op_fcvt_w_d
-    { "fcvt.wu.d", rv_codec_r_m, rv_fmt_rm_rd_frs1 }, // op_fcvt_wu_d
-    { "fcvt.d.w", rv_codec_r_m, rv_fmt_rm_frd_rs1 }, // op_fcvt_d_w
-    { "fcvt.d.wu", rv_codec_r_m, rv_fmt_rm_frd_rs1 }, // op_fcvt_d_wu
-    { "fcvt.l.d", rv_codec_r_m, rv_fmt_rm_rd_frs1 }, // op_fcvt_l_d
-    { "fcvt.lu.d", rv_codec_r_m, rv_fmt_rm_rd_frs1 }, // op_fcvt_lu_d
-    { "fmv.x.d", rv_codec_r, rv_fmt_rd_frs1 }, // op_fmv_x_d
-    { "fcvt.d.l", rv_codec_r_m, rv_fmt_rm_frd_rs1 }, // op_fcvt_d_l
-    { "fcvt.d.lu", rv_codec_r_m, rv_fmt_rm_frd_rs1 }, // op_fcvt_d_lu
-    { "fmv.d.x", rv_codec_r, rv_fmt_frd_rs1 }, // op_fmv_d_x
-    { "flq", rv_codec_i, rv_fmt_frd_offset_rs1 }, // op_flq
-    { "fsq", rv_codec_s, rv_fmt_frs2_offset_rs1 }, // op_fsq
-    { "fmadd.q", rv_codec_r4_m, rv_fmt_rm_frd_frs1_frs2_frs3 }, // op_fmadd_q
-    { "fmsub.q", rv_codec_r4_m, rv_fmt_rm_frd_frs1_frs2_frs3 }, // op_fmsub_q
-    { "fnmsub.q", rv_codec_r4_m, rv_fmt_rm_frd_frs1_frs2_frs3 }, // op_fnmsub_q
-    { "fnmadd.q", rv_codec_r4_m, rv_fmt_rm_frd_frs1_frs2_frs3 }, // op_fnmadd_q
-    { "fadd.q", rv_codec_r_m, rv_fmt_rm_frd_frs1_frs2 }, // op_fadd_q
-    { "fsub.q", rv_codec_r_m, rv_fmt_rm_frd_frs1_frs2 }, // op_fsub_q
-    { "fmul.q", rv_codec_r_m, rv_fmt_rm_frd_frs1_frs2 }, // op_fmul_q
-    { "fdiv.q", rv_codec_r_m, rv_fmt_rm_frd_frs1_frs2 }, // op_fdiv_q
-    { "fsqrt.q", rv_codec_r_m, rv_fmt_rm_frd_frs1 }, // op_fsqrt_q
-    { "fsgnj.q", rv_codec_r, rv_fmt_frd_frs1_frs2 }, // op_fsgnj_q
-    { "fsgnjn.q", rv_codec_r, rv_fmt_frd_frs1_frs2 }, // op_fsgnjn_q
-    { "fsgnjx.q", rv_codec_r, rv_fmt_frd_frs1_frs2 }, // op_fsgnjx_q
-    { "fmin.q", rv_codec_r, rv_fmt_frd_frs1_frs2 }, // op_fmin_q
-    { "fmax.q", rv_codec_r, rv_fmt_frd_frs1_frs2 }, // op_fmax_q
-    { "fcvt.s.q", rv_codec_r_m, rv_fmt_rm_frd_frs1 }, // op_fcvt_s_q
-    { "fcvt.q.s", rv_codec_r_m, rv_fmt_rm_frd_frs1 }, // op_fcvt_q_s
-    { "fcvt.d.q", rv_codec_r_m, rv_fmt_rm_frd_frs1 }, // op_fcvt_d_q
-    { "fcvt.q.d", rv_codec_r_m, rv_fmt_rm_frd_frs1 }, // op_fcvt_q_d
-    { "feq.q", rv_codec_r, rv_fmt_rd_frs1_frs2 }, // op_feq_q
-    { "flt.q", rv_codec_r, rv_fmt_rd_frs1_frs2 }, // op_flt_q
-    { "fle.q", rv_codec_r, rv_fmt_rd_frs1_frs2 }, // op_fle_q
-    { "fclass.q", rv_codec_r, rv_fmt_rd_frs1 }, // op_fclass_q
-    { "fcvt.w.q", rv_codec_r_m, rv_fmt_rm_rd_frs1 }, // op_fcvt_w_q
-    { "fcvt.wu.q", rv_codec_r_m, rv_fmt_rm_rd_frs1}, // op_fcvt_wu_q
-    { "fcvt.q.w", rv_codec_r_m, rv_fmt_rm_frd_rs1 }, // op_fcvt_q_w
-    { "fcvt.q.wu", rv_codec_r_m, rv_fmt_rm_frd_rs1 }, // op_fcvt_q_wu
-    { "fcvt.l.q", rv_codec_r_m, rv_fmt_rm_rd_frs1 }, // op_fcvt_l_q
-    { "fcvt.lu.q", rv_codec_r_m, rv_fmt_rm_rd_frs1 }, // op_fcvt_lu_q
-    { "fcvt.q.l", rv_codec_r_m, rv_fmt_rm_frd_rs1 }, // op_fcvt_q_l
-    { "fcvt.q.lu", rv_codec_r_m, rv_fmt_rm_frd_rs1 }, // op_fcvt_q_lu
-    { "flh", rv_codec_i, rv_fmt_frd_offset_rs1 }, // op_flh
-    { "fsh", rv_codec_s, rv_fmt_frs2_offset_rs1 }, // op_fsh
-    { "fmadd.h", rv_codec_r4_m, rv_fmt_rm_frd_frs1_frs2_frs3 }, // op_fmadd_h
-    { "fmsub.h", rv_codec_r4_m, rv_fmt_rm_frd_frs1_frs2_frs3 }, // op_fmsub_h
-    { "fnmsub.h", rv_codec_r4_m, rv_fmt_rm_frd_frs1_frs2_frs3 }, // op_fnmsub_h
-    { "fnmadd.h", rv_codec_r4_m, rv_fmt_rm_frd_frs1_frs2_frs3 }, // op_fnmadd_h
-    { "fadd.h", rv_codec_r_m, rv_fmt_rm_frd_frs1_frs2 }, // op_fadd_h
-    { "fsub.h", rv_codec_r_m, rv_fmt_rm_frd_frs1_frs2 }, // op_fsub_h
-    { "fmul.h", rv_codec_r_m, rv_fmt_rm_frd_frs1_frs2 }, // op_fmul_h
-    { "fdiv.h", rv_codec_r_m, rv_fmt_rm_frd_frs1_frs2 }, // op_fdiv_h
-    { "fsqrt.h", rv_codec_r_m, rv_fmt_rm_frd_frs1 }, // op_fsqrt_h
-    { "fsgnj.h", rv_codec_r, rv_fmt_frd_frs1_frs2 }, // op_fsgnj_h
-    { "fsgnjn.h", rv_codec_r, rv_fmt_frd_frs1_frs2 }, // op_fsgnjn_h
-    { "fsgnjx.h", rv_codec_r, rv_fmt_frd_frs1_frs2 }, // op_fsgnjx_h
-    { "fmin.h", rv_codec_r, rv_fmt_frd_frs1_frs2 }, // op_fmin_h
-    { "fmax.h", rv_codec_r, rv_fmt_frd_frs1_frs2 }, // op_fmax_h
-    { "fcvt.s.h", rv_codec_r_m, rv_fmt_rm_frd_frs1 }, // op_fcvt_s_h
-    { "fcvt.h.s", rv_codec_r_m, rv_fmt_rm_frd_frs1 }, // op_fcvt_h_s
-    { "fcvt.d.h", rv_codec_r_m, rv_fmt_rm_frd_frs1 }, // op_fcvt_d_h
-    { "fcvt.h.d", rv_codec_r_m, rv_fmt_rm_frd_frs1 }, // op_fcvt_h_d
-    { "fcvt.q.h", rv_codec_r_m, rv_fmt_rm_frd_frs1 }, // op_fcvt_q_h
-    { "fcvt.h.q", rv_codec_r_m, rv_fmt_rm_frd_frs1 }, // op_fcvt_h_q
-    { "feq.h", rv_codec_r, rv_fmt_rd_frs1_frs2 }, // op_feq_h
-    { "flt.h", rv_codec_r, rv_fmt_rd_frs1_frs2 }, // op_flt_h
-    { "fle.h", rv_codec_r, rv_fmt_rd_frs1_frs2 }, // op_fle_h
-    { "fclass.h", rv_codec_r, rv_fmt_rd_frs1 }, // op_fclass_h
-    { "fcvt.w.h", rv_codec_r_m, rv_fmt_rm_rd_frs1 }, // op_fcvt_w_h
-    { "fcvt.wu.h", rv_codec_r_m, rv_fmt_rm_rd_frs1 }, // op_fcvt_wu_h
-    { "fmv.x.h", rv_codec_r, rv_fmt_rd_frs1 }, // op_fmv_x_h
-    { "fcvt.h.w", rv_codec_r_m, rv_fmt_rm_frd_rs1 }, // op_fcvt_h_w
-    { "fcvt.h.wu", rv_codec_r_m, rv_fmt_rm_frd_rs1 }, // op_fcvt_h_wu
-    { "fmv.h.x", rv_codec_r, rv_fmt_frd_rs1 }, // op_fmv_h_x
-    { "fcvt.l.h", rv_codec_r_m, rv_fmt_rm_rd_frs1 }, // op_fcvt_l_h
-    { "fcvt.lu.h", rv_codec_r_m, rv_fmt_rm_rd_frs1 }, // op_fcvt_lu_h
-    { "fcvt.h.l", rv_codec_r_m, rv_fmt_rm_frd_rs1 }, // op_fcvt_h_l
-    { "fcvt.h.lu", rv_codec_r_m, rv_fmt_rm_frd_rs1 }, // op_fcvt_h_lu
-    { "wrs.nto", rv_codec_ci_none, rv_fmt_none }, // op_wrs_nto
-    { "wrs.sto", rv_codec_ci_none, rv_fmt_none } // op_wrs_sto
-};
+#define DECODE_SLOTS        64
+
+// First level: RVC quadrant + funct3 (0..23) or 32 + major opcode (32..63)
+// Second level: up to two bit fields some encoding of the slot tests, indexing its buckets directly
+// key = (byte_data >> shift_lo) & mask_lo | (byte_data >> shift_hi) & mask_hi, mask_hi sits above mask_lo
+typedef struct {
+    uint8_t shift_lo;
+    uint8_t shift_hi;
+    uint16_t bucket;
+    uint16_t mask_lo;
+    uint16_t mask_hi;
+} rv_decode_slot;
+
+// Encoding of the bucket, next - bucket of the next less specific one that shares the key, 0 - none
+// An empty bucket never matches and has no next, so it decodes to op_illegal
+typedef struct {
+    uint32_t mask;
+    uint32_t match;
+    uint16_t op;
+    uint16_t next;
+} rv_decode_bucket;
+
+#define RVC_RECORDS         65536
+
+// Decoded 16-bit parcel: rd, rs1 and rs2 packed 5 bits each, imm already sign-extended
+typedef struct {
+    int32_t imm;
+    uint16_t opcode;
+    uint16_t regs;
+} rv_rvc_record;
+
+// rvc - every 16-bit parcel decoded in advance by rvc_records_init()
+typedef struct {
+    const rv_decode_slot *slot;
+    const rv_decode_bucket *bucket;
+    const rv_rvc_record *rvc;
+} rv_decode_table;
+
+static rv_rvc_record rvc_records[3][RVC_RECORDS];
+
+// opcode_data[], decode_tables[rv32/rv64/rv128] AND THE CSR NAMES, GENERATED BY gen_opcodes
+// FROM risc_v_opcodes.spec AND risc_v_csrs.list
+#include "risc_v_opcodes.inc"
+
+// SLOT OF THE FIRST LEVEL: RVC QUADRANT + FUNCT3 OR 32 + MAJOR OPCODE
+// gen_opcodes.c KEYS THE GENERATED TABLES BY COPIES OF THESE TWO FUNCTIONS
+static uint8_t decode_slot_index(uint32_t byte_data) {
+    uint8_t rvc = ((byte_data & 0b11) << 3) | ((byte_data >> 13) & 0b111);
+    uint8_t major = 32 + ((byte_data >> 2) & 0b11111);
+    // 1 FOR A 32-BIT COMMAND, SO THE INDEX IS PICKED WITHOUT A BRANCH, RVC AND 32-BIT COMMANDS INTERLEAVE
+    uint8_t wide = ((byte_data & 0b11) + 1) >> 2;
+
+    return rvc ^ ((rvc ^ major) & -wide);
+}
+
+static uint32_t decode_bucket_key(const rv_decode_slot *slot, uint32_t byte_data) {
+    return ((byte_data >> (*slot).shift_lo) & (*slot).mask_lo) | ((byte_data >> (*slot).shift_hi) & (*slot).mask_hi);
+}
+
+// OPCODE OF byte_data UNDER THE WIDTH OF table, LOOPS PICK table ONCE BY decode_tables[pc]
+static rv_op decode_op(const rv_decode_table *table, uint32_t byte_data) {
+    const rv_decode_slot *slot = &(*table).slot[decode_slot_index(byte_data)];
+    const rv_decode_bucket *bucket = &(*table).bucket[(*slot).bucket + decode_bucket_key(slot, byte_data)];
+
+    while ((byte_data & (*bucket).mask) != (*bucket).match) {
+        if ((*bucket).next == 0) {
+            return op_illegal;
+        }
+        bucket = &(*table).bucket[(*bucket).next];
+    }
+    return (*bucket).op;
+}
+
+#define DECODE_MEMO_MIN_BITS    6
+#define DECODE_MEMO_MAX_BITS    24
+
+// Fields a codec fills for the 32-bit word byte_data under width pc, byte_data 0 - empty entry
+typedef struct {
+    uint32_t byte_data;
+    int32_t imm;
+    uint16_t opcode;
+    uint8_t pc;
+    uint8_t rd;
+    uint8_t rs1;
+    uint8_t rs2;
+    uint8_t rs3;
+    uint8_t rm;
+    uint8_t pred;
+    uint8_t succ;
+    uint8_t aq;
+    uint8_t rl;
+} rv_memo_entry;
+
+// Direct-mapped hot-word cache, 1 << (32 - shift) entries, entry NULL - off
+typedef struct {
+    rv_memo_entry *entry;
+    uint8_t shift;
+    uint64_t hits;
+    uint64_t misses;
+} rv_decode_memo;
+
+// EVERY THREAD HAS ITS OWN, SET BY decode_cache_enable()
+// 16-BIT PARCELS NEVER GO THROUGH IT, rvc_records[] ALREADY HOLDS ALL OF THEM
+static __thread rv_decode_memo decode_memo;
+
+// DECODE AND PARSE THE 32-BIT WORD OF cd THROUGH decode_memo, A HIT SKIPS bp_opcode() AND THE CODEC
+static void decode_memo_command(const rv_decode_table *table, command_data *cd) {
+    uint8_t pc = table - decode_tables;
+    rv_memo_entry *entry = &decode_memo.entry[(((*cd).byte_data + pc) * 0x9e3779b1u) >> decode_memo.shift];
+
+    if ((*entry).byte_data == (*cd).byte_data && (*entry).pc == pc) {
+        decode_memo.hits++;
+        (*cd).opcode = (*entry).opcode;
+        (*cd).imm = (*entry).imm;
+        (*cd).rd = (*entry).rd;
+        (*cd).rs1 = (*entry).rs1;
+        (*cd).rs2 = (*entry).rs2;
+        (*cd).rs3 = (*entry).rs3;
+        (*cd).rm = (*entry).rm;
+        (*cd).pred = (*entry).pred;
+        (*cd).succ = (*entry).succ;
+        (*cd).aq = (*entry).aq;
+        (*cd).rl = (*entry).rl;
+        return;
+    }
+    decode_memo.misses++;
+    bp_opcode(cd);
+    opcode_data[(*cd).opcode].parse_func(cd);
+    (*entry).byte_data = (*cd).byte_data;
+    (*entry).pc = pc;
+    (*entry).opcode = (*cd).opcode;
+    (*entry).imm = (*cd).imm;
+    (*entry).rd = (*cd).rd;
+    (*entry).rs1 = (*cd).rs1;
+    (*entry).rs2 = (*cd).rs2;
+    (*entry).rs3 = (*cd).rs3;
+    (*entry).rm = (*cd).rm;
+    (*entry).pred = (*cd).pred;
+    (*entry).succ = (*cd).succ;
+    (*entry).aq = (*cd).aq;
+    (*entry).rl = (*cd).rl;
+}
+
+// DECODE AND PARSE cd UNDER THE WIDTH OF table, A 16-BIT PARCEL IS A SINGLE RECORD LOOKUP
+// A 32-BIT WORD GOES THROUGH bp_opcode(), WITH ITS CODEC THE SWITCH STAYS FASTER THAN decode_op()
+static void decode_command(const rv_decode_table *table, command_data *cd) {
+    if (((*cd).byte_data & 0b11) != 0b11) {
+        const rv_rvc_record *record = &(*table).rvc[(*cd).byte_data & 0xffff];
+        (*cd).opcode = (*record).opcode;
+        (*cd).rd = (*record).regs & 0x1f;
+        (*cd).rs1 = ((*record).regs >> 5) & 0x1f;
+        (*cd).rs2 = (*record).regs >> 10;
+        (*cd).imm = (*record).imm;
+        return;
+    }
+    if (decode_memo.entry != NULL) {
+        decode_memo_command(table, cd);
+        return;
+    }
+    bp_opcode(cd);
+    opcode_data[(*cd).opcode].parse_func(cd);
+}
+
+// RUN THE TABLE DECODER AND THE CODEC OVER EVERY 16-BIT PARCEL OF EVERY WIDTH ONCE
+static void rvc_records_init(void) {
+    command_data cd;
+
+    for (uint8_t pc = rv32; pc <= rv128; pc++) {
+        cd.pc = pc;
+        for (uint32_t parcel = 0; parcel < RVC_RECORDS; parcel++) {
+            if ((parcel & 0b11) == 0b11) {
+                continue;
+            }
+            cd.byte_data = parcel;
+            cd.opcode = decode_op(&decode_tables[pc], parcel);
+            opcode_data[cd.opcode].parse_func(&cd);
+            rvc_records[pc][parcel].imm = cd.imm;
+            rvc_records[pc][parcel].opcode = cd.opcode;
+            rvc_records[pc][parcel].regs = cd.rd | (cd.rs1 << 5) | (cd.rs2 << 10);
+        }
+    }
+}
 
 //================================================================
 //========================= CSR NAME =============================
 //================================================================
 
-static const char *csr_name(int csrno)
-{
-    switch (csrno) {
-    case 0x0000: return "ustatus";
-    case 0x0001: return "fflags";
-    case 0x0002: return "frm";
-    case 0x0003: return "fcsr";
-    case 0x0004: return "uie";
-    case 0x0005: return "utvec";
-    case 0x0007: return "utvt";
-    case 0x0008: return "vstart";
-    case 0x0009: return "vxsat";
-    case 0x000a: return "vxrm";
-    case 0x000f: return "vcsr";
-    case 0x0040: return "uscratch";
-    case 0x0041: return "uepc";
-    case 0x0042: return "ucause";
-    case 0x0043: return "utval";
-    case 0x0044: return "uip";
-    case 0x0045: return "unxti";
-    case 0x0046: return "uintstatus";
-    case 0x0048: return "uscratchcsw";
-    case 0x0049: return "uscratchcswl";
-    case 0x0100: return "sstatus";
-    case 0x0102: return "sedeleg";
-    case 0x0103: return "sideleg";
-    case 0x0104: return "sie";
-    case 0x0105: return "stvec";
-    case 0x0106: return "scounteren";
-    case 0x0107: return "stvt";
-    case 0x0140: return "sscratch";
-    case 0x0141: return "sepc";
-    case 0x0142: return "scause";
-    case 0x0143: return "stval";
-    case 0x0144: return "sip";
-    case 0x0145: return "snxti";
-    case 0x0146: return "sintstatus";
-    case 0x0148: return "sscratchcsw";
-    case 0x0149: return "sscratchcswl";
-    case 0x0180: return "satp";
-    case 0x0200: return "vsstatus";
-    case 0x0204: return "vsie";
-    case 0x0205: return "vstvec";
-    case 0x0240: return "vsscratch";
-    case 0x0241: return "vsepc";
-    case 0x0242: return "vscause";
-    case 0x0243: return "vstval";
-    case 0x0244: return "vsip";
-    case 0x0280: return "vsatp";
-    case 0x0300: return "mstatus";
-    case 0x0301: return "misa";
-    case 0x0302: return "medeleg";
-    case 0x0303: return "mideleg";
-    case 0x0304: return "mie";
-    case 0x0305: return "mtvec";
-    case 0x0306: return "mcounteren";
-    case 0x0307: return "mtvt";
-    case 0x0310: return "mstatush";
-    case 0x0320: return "mcountinhibit";
-    case 0x0323: return "mhpmevent3";
-    case 0x0324: return "mhpmevent4";
-    case 0x0325: return "mhpmevent5";
-    case 0x0326: return "mhpmevent6";
-    case 0x0327: return "mhpmevent7";
-    case 0x0328: return "mhpmevent8";
-    case 0x0329: return "mhpmevent9";
-    case 0x032a: return "mhpmevent10";
-    case 0x032b: return "mhpmevent11";
-    case 0x032c: return "mhpmevent12";
-    case 0x032d: return "mhpmevent13";
-    case 0x032e: return "mhpmevent14";
-    case 0x032f: return "mhpmevent15";
-    case 0x0330: return "mhpmevent16";
-    case 0x0331: return "mhpmevent17";
-    case 0x0332: return "mhpmevent18";
-    case 0x0333: return "mhpmevent19";
-    case 0x0334: return "mhpmevent20";
-    case 0x0335: return "mhpmevent21";
-    case 0x0336: return "mhpmevent22";
-    case 0x0337: return "mhpmevent23";
-    case 0x0338: return "mhpmevent24";
-    case 0x0339: return "mhpmevent25";
-    case 0x033a: return "mhpmevent26";
-    case 0x033b: return "mhpmevent27";
-    case 0x033c: return "mhpmevent28";
-    case 0x033d: return "mhpmevent29";
-    case 0x033e: return "mhpmevent30";
-    case 0x033f: return "mhpmevent31";
-    case 0x0340: return "mscratch";
-    case 0x0341: return "mepc";
-    case 0x0342: return "mcause";
-    case 0x0343: return "mtval";
-    case 0x0344: return "mip";
-    case 0x0345: return "mnxti";
-    case 0x0346: return "mintstatus";
-    case 0x0348: return "mscratchcsw";
-    case 0x0349: return "mscratchcswl";
-    case 0x034a: return "mtinst";
-    case 0x034b: return "mtval2";
-    case 0x03a0: return "pmpcfg0";
-    case 0x03a1: return "pmpcfg1";
-    case 0x03a2: return "pmpcfg2";
-    case 0x03a3: return "pmpcfg3";
-    case 0x03b0: return "pmpaddr0";
-    case 0x03b1: return "pmpaddr1";
-    case 0x03b2: return "pmpaddr2";
-    case 0x03b3: return "pmpaddr3";
-    case 0x03b4: return "pmpaddr4";
-    case 0x03b5: return "pmpaddr5";
-    case 0x03b6: return "pmpaddr6";
-    case 0x03b7: return "pmpaddr7";
-    case 0x03b8: return "pmpaddr8";
-    case 0x03b9: return "pmpaddr9";
-    case 0x03ba: return "pmpaddr10";
-    case 0x03bb: return "pmpaddr11";
-    case 0x03bc: return "pmpaddr12";
-    case 0x03bd: return "pmpaddr13";
-    case 0x03be: return "pmpaddr14";
-    case 0x03bf: return "pmpaddr15";
-    case 0x0600: return "hstatus";
-    case 0x0602: return "hedeleg";
-    case 0x0603: return "hideleg";
-    case 0x0604: return "hie";
-    case 0x0605: return "htimedelta";
-    case 0x0606: return "hcounteren";
-    case 0x0607: return "hgeie";
-    case 0x0615: return "htimedeltah";
-    case 0x0643: return "htval";
-    case 0x0644: return "hip";
-    case 0x0645: return "hvip";
-    case 0x064a: return "htinst";
-    case 0x0680: return "hgatp";
-    case 0x07a0: return "tselect";
-    case 0x07a1: return "tdata1";
-    case 0x07a2: return "tdata2";
-    case 0x07a3: return "tdata3";
-    case 0x07a4: return "tinfo";
-    case 0x07a5: return "tcontrol";
-    case 0x07a8: return "mcontext";
-    case 0x07a9: return "mnoise";
-    case 0x07aa: return "scontext";
-    case 0x07b0: return "dcsr";
-    case 0x07b1: return "dpc";
-    case 0x07b2: return "dscratch0";
-    case 0x07b3: return "dscratch1";
-    case 0x0b00: return "mcycle";
-    case 0x0b02: return "minstret";
-    case 0x0b03: return "mhpmcounter3";
-    case 0x0b04: return "mhpmcounter4";
-    case 0x0b05: return "mhpmcounter5";
-    case 0x0b06: return "mhpmcounter6";
-    case 0x0b07: return "mhpmcounter7";
-    case 0x0b08: return "mhpmcounter8";
-    case 0x0b09: return "mhpmcounter9";
-    case 0x0b0a: return "mhpmcounter10";
-    case 0x0b0b: return "mhpmcounter11";
-    case 0x0b0c: return "mhpmcounter12";
-    case 0x0b0d: return "mhpmcounter13";
-    case 0x0b0e: return "mhpmcounter14";
-    case 0x0b0f: return "mhpmcounter15";
-    case 0x0b10: return "mhpmcounter16";
-    case 0x0b11: return "mhpmcounter17";
-    case 0x0b12: return "mhpmcounter18";
-    case 0x0b13: return "mhpmcounter19";
-    case 0x0b14: return "mhpmcounter20";
-    case 0x0b15: return "mhpmcounter21";
-    case 0x0b16: return "mhpmcounter22";
-    case 0x0b17: return "mhpmcounter23";
-    case 0x0b18: return "mhpmcounter24";
-    case 0x0b19: return "mhpmcounter25";
-    case 0x0b1a: return "mhpmcounter26";
-    case 0x0b1b: return "mhpmcounter27";
-    case 0x0b1c: return "mhpmcounter28";
-    case 0x0b1d: return "mhpmcounter29";
-    case 0x0b1e: return "mhpmcounter30";
-    case 0x0b1f: return "mhpmcounter31";
-    case 0x0b80: return "mcycleh";
-    case 0x0b82: return "minstreth";
-    case 0x0b83: return "mhpmcounter3h";
-    case 0x0b84: return "mhpmcounter4h";
-    case 0x0b85: return "mhpmcounter5h";
-    case 0x0b86: return "mhpmcounter6h";
-    case 0x0b87: return "mhpmcounter7h";
-    case 0x0b88: return "mhpmcounter8h";
-    case 0x0b89: return "mhpmcounter9h";
-    case 0x0b8a: return "mhpmcounter10h";
-    case 0x0b8b: return "mhpmcounter11h";
-    case 0x0b8c: return "mhpmcounter12h";
-    case 0x0b8d: return "mhpmcounter13h";
-    case 0x0b8e: return "mhpmcounter14h";
-    case 0x0b8f: return "mhpmcounter15h";
-    case 0x0b90: return "mhpmcounter16h";
-    case 0x0b91: return "mhpmcounter17h";
-    case 0x0b92: return "mhpmcounter18h";
-    case 0x0b93: return "mhpmcounter19h";
-    case 0x0b94: return "mhpmcounter20h";
-    case 0x0b95: return "mhpmcounter21h";
-    case 0x0b96: return "mhpmcounter22h";
-    case 0x0b97: return "mhpmcounter23h";
-    case 0x0b98: return "mhpmcounter24h";
-    case 0x0b99: return "mhpmcounter25h";
-    case 0x0b9a: return "mhpmcounter26h";
-    case 0x0b9b: return "mhpmcounter27h";
-    case 0x0b9c: return "mhpmcounter28h";
-    case 0x0b9d: return "mhpmcounter29h";
-    case 0x0b9e: return "mhpmcounter30h";
-    case 0x0b9f: return "mhpmcounter31h";
-    case 0x0c00: return "cycle";
-    case 0x0c01: return "time";
-    case 0x0c02: return "instret";
-    case 0x0c03: return "hpmcounter3";
-    case 0x0c04: return "hpmcounter4";
-    case 0x0c05: return "hpmcounter5";
-    case 0x0c06: return "hpmcounter6";
-    case 0x0c07: return "hpmcounter7";
-    case 0x0c08: return "hpmcounter8";
-    case 0x0c09: return "hpmcounter9";
-    case 0x0c0a: return "hpmcounter10";
-    case 0x0c0b: return "hpmcounter11";
-    case 0x0c0c: return "hpmcounter12";
-    case 0x0c0d: return "hpmcounter13";
-    case 0x0c0e: return "hpmcounter14";
-    case 0x0c0f: return "hpmcounter15";
-    case 0x0c10: return "hpmcounter16";
-    case 0x0c11: return "hpmcounter17";
-    case 0x0c12: return "hpmcounter18";
-    case 0x0c13: return "hpmcounter19";
-    case 0x0c14: return "hpmcounter20";
-    case 0x0c15: return "hpmcounter21";
-    case 0x0c16: return "hpmcounter22";
-    case 0x0c17: return "hpmcounter23";
-    case 0x0c18: return "hpmcounter24";
-    case 0x0c19: return "hpmcounter25";
-    case 0x0c1a: return "hpmcounter26";
-    case 0x0c1b: return "hpmcounter27";
-    case 0x0c1c: return "hpmcounter28";
-    case 0x0c1d: return "hpmcounter29";
-    case 0x0c1e: return "hpmcounter30";
-    case 0x0c1f: return "hpmcounter31";
-    case 0x0c20: return "vl";
-    case 0x0c21: return "vtype";
-    case 0x0c22: return "vlenb";
-    case 0x0c80: return "cycleh";
-    case 0x0c81: return "timeh";
-    case 0x0c82: return "instreth";
-    case 0x0c83: return "hpmcounter3h";
-    case 0x0c84: return "hpmcounter4h";
-    case 0x0c85: return "hpmcounter5h";
-    case 0x0c86: return "hpmcounter6h";
-    case 0x0c87: return "hpmcounter7h";
-    case 0x0c88: return "hpmcounter8h";
-    case 0x0c89: return "hpmcounter9h";
-    case 0x0c8a: return "hpmcounter10h";
-    case 0x0c8b: return "hpmcounter11h";
-    case 0x0c8c: return "hpmcounter12h";
-    case 0x0c8d: return "hpmcounter13h";
-    case 0x0c8e: return "hpmcounter14h";
-    case 0x0c8f: return "hpmcounter15h";
-    case 0x0c90: return "hpmcounter16h";
-    case 0x0c91: return "hpmcounter17h";
-    case 0x0c92: return "hpmcounter18h";
-    case 0x0c93: return "hpmcounter19h";
-    case 0x0c94: return "hpmcounter20h";
-    case 0x0c95: return "hpmcounter21h";
-    case 0x0c96: return "hpmcounter22h";
-    case 0x0c97: return "hpmcounter23h";
-    case 0x0c98: return "hpmcounter24h";
-    case 0x0c99: return "hpmcounter25h";
-    case 0x0c9a: return "hpmcounter26h";
-    case 0x0c9b: return "hpmcounter27h";
-    case 0x0c9c: return "hpmcounter28h";
-    case 0x0c9d: return "hpmcounter29h";
-    case 0x0c9e: return "hpmcounter30h";
-    case 0x0c9f: return "hpmcounter31h";
-    case 0x0e12: return "hgeip";
-    case 0x0f11: return "mvendorid";
-    case 0x0f12: return "marchid";
-    case 0x0f13: return "mimpid";
-    case 0x0f14: return "mhartid";
-    case 0x0f15: return "mentropy";
-    default: return NULL;
+// LENGTH OF THE NAME OF CSR csrno, 0 IF IT HAS NONE, *text - THE NAME
+// csr_name_pool[] AND csr_name_offset[] ARE GENERATED FROM risc_v_csrs.list
+static uint8_t csr_name(uint32_t csrno, const char **text) {
+    const char *entry = &csr_name_pool[csr_name_offset[csrno & 0xfff]];
+
+    *text = entry + 1;
+    return (uint8_t)entry[0];
+}
+
+//================================================================
+//====================== Register Names ==========================
+//================================================================
+
+// Name padded to 4 bytes, copied by one fixed-size memcpy, and its length
+typedef struct {
+    char text[4];
+    uint8_t len;
+} rv_short_name;
+
+static const rv_short_name rv_ireg_name[32] = {
+    {"zero", 4}, {"ra", 2},   {"sp", 2},   {"gp", 2},   {"tp", 2},   {"t0", 2},   {"t1", 2},   {"t2", 2},
+    {"s0", 2},   {"s1", 2},   {"a0", 2},   {"a1", 2},   {"a2", 2},   {"a3", 2},   {"a4", 2},   {"a5", 2},
+    {"a6", 2},   {"a7", 2},   {"s2", 2},   {"s3", 2},   {"s4", 2},   {"s5", 2},   {"s6", 2},   {"s7", 2},
+    {"s8", 2},   {"s9", 2},   {"s10", 3},  {"s11", 3},  {"t3", 2},   {"t4", 2},   {"t5", 2},   {"t6", 2},
+};
+
+static const rv_short_name rv_freg_name[32] = {
+    {"ft0", 3},  {"ft1", 3},  {"ft2", 3},  {"ft3", 3},  {"ft4", 3},  {"ft5", 3},  {"ft6", 3},  {"ft7", 3},
+    {"fs0", 3},  {"fs1", 3},  {"fa0", 3},  {"fa1", 3},  {"fa2", 3},  {"fa3", 3},  {"fa4", 3},  {"fa5", 3},
+    {"fa6", 3},  {"fa7", 3},  {"fs2", 3},  {"fs3", 3},  {"fs4", 3},  {"fs5", 3},  {"fs6", 3},  {"fs7", 3},
+    {"fs8", 3},  {"fs9", 3},  {"fs10", 4}, {"fs11", 4}, {"ft8", 3},  {"ft9", 3},  {"ft10", 4}, {"ft11", 4},
+};
+
+// INDEXED BY THE rm FIELD, 5 AND 6 ARE RESERVED
+static const rv_short_name rv_rm_name[8] = {
+    {"rne", 3},  {"rtz", 3},  {"rdn", 3},  {"rup", 3},  {"rmm", 3},  {"inv", 3},  {"inv", 3},  {"dyn", 3},
+};
+
+//================================================================
+//========================= Number Text ==========================
+//================================================================
+
+static const char hex_digits[] = "0123456789abcdef";
+
+// "00" "01" ... "99", TWO DECIMAL DIGITS PER DIVISION
+static const char dec_pairs[201] =
+    "0001020304050607080910111213141516171819"
+    "2021222324252627282930313233343536373839"
+    "4041424344454647484950515253545556575859"
+    "6061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+// AT LEAST digits LOWERCASE HEX DIGITS OF value, NO "0x", RETURN THE END
+// THE LENGTH IS KNOWN BEFORE THE FIRST DIGIT, SO THEY ARE WRITTEN IN PLACE FROM THE LAST ONE
+static char *text_hex(char *tmp_ptr, uint64_t value, uint8_t digits) {
+    uint8_t len = digits;
+
+    while (len < 16 && (value >> (4 * len)) != 0) {
+        len++;
+    }
+    for (uint8_t i = len; i > 0; i--) {
+        tmp_ptr[i - 1] = hex_digits[value & 0xf];
+        value >>= 4;
+    }
+    return tmp_ptr + len;
+}
+
+// DECIMAL DIGITS OF value, LIKE "%lu", RETURN THE END
+static char *text_udec(char *tmp_ptr, uint64_t value) {
+    char tmp[20];
+    uint8_t pos = sizeof(tmp);
+
+    while (value >= 100) {
+        pos -= 2;
+        memcpy(&tmp[pos], &dec_pairs[2 * (value % 100)], 2);
+        value /= 100;
+    }
+    if (value >= 10) {
+        pos -= 2;
+        memcpy(&tmp[pos], &dec_pairs[2 * value], 2);
+    } else {
+        pos--;
+        tmp[pos] = '0' + value;
+    }
+    memcpy(tmp_ptr, &tmp[pos], sizeof(tmp) - pos);
+    return tmp_ptr + sizeof(tmp) - pos;
+}
+
+// LIKE "%d" OF value, RETURN THE END
+static char *text_dec(char *tmp_ptr, int32_t value) {
+    if (value < 0) {
+        *tmp_ptr++ = '-';
+        return text_udec(tmp_ptr, -(uint64_t)value);
+    }
+    return text_udec(tmp_ptr, value);
+}
+
+//================================================================
+//========================= Label Set ============================
+//================================================================
+
+// OPEN ADDRESSING WITH LINEAR PROBING, mask + 1 SLOTS, AT LEAST HALF OF THEM EMPTY
+// TARGETS ARE EVEN, BIT 0 OF A SLOT MARKS A TARGET THAT IS THE OFFSET OF A LISTED COMMAND
+#define LABEL_EMPTY     UINT64_MAX
+
+typedef struct {
+    uint64_t *slot;
+    size_t mask;
+} label_set;
+
+static size_t label_hash(const label_set *set, uint64_t address) {
+    return (size_t)(((address >> 1) * 0x9e3779b97f4a7c15ull) >> 32) & (*set).mask;
+}
+
+// ROOM FOR max_labels ADDRESSES
+static uint8_t label_set_init(label_set *set, size_t max_labels) {
+    size_t capacity = 16;
+
+    while (capacity < 2 * max_labels) {
+        capacity *= 2;
+    }
+    if (((*set).slot = malloc(capacity * sizeof(uint64_t))) == NULL) {
+        return 1;
+    }
+    memset((*set).slot, 0xff, capacity * sizeof(uint64_t));
+    (*set).mask = capacity - 1;
+    return 0;
+}
+
+static void label_set_free(label_set *set) {
+    free((*set).slot);
+    (*set).slot = NULL;
+}
+
+// SLOT OF address, OR OF THE EMPTY SLOT WHERE IT WOULD GO
+static uint64_t *label_set_find(const label_set *set, uint64_t address) {
+    size_t i = label_hash(set, address);
+
+    while ((*set).slot[i] != LABEL_EMPTY && ((*set).slot[i] & ~1ull) != address) {
+        i = (i + 1) & (*set).mask;
+    }
+    return &(*set).slot[i];
+}
+
+static void label_set_add(label_set *set, uint64_t address) {
+    uint64_t *slot = label_set_find(set, address);
+
+    if (*slot == LABEL_EMPTY) {
+        *slot = address;
+    }
+}
+
+// MARK address AS LISTED IF IT IS A TARGET
+static void label_set_confirm(label_set *set, uint64_t address) {
+    uint64_t *slot = label_set_find(set, address);
+
+    if (*slot != LABEL_EMPTY) {
+        *slot |= 1;
+    }
+}
+
+// 1 IF address IS A TARGET THAT IS LISTED
+static uint8_t label_set_has(const label_set *set, uint64_t address) {
+    return *label_set_find(set, address) == (address | 1);
+}
+
+// 1 FOR JUMPS AND BRANCHES WHOSE 'o' OPERAND IS THEIR TARGET
+static uint8_t label_is_target(uint16_t opcode) {
+    switch (opcode) {
+    case op_beq:
+    case op_bne:
+    case op_blt:
+    case op_bge:
+    case op_bltu:
+    case op_bgeu:
+    case op_jal:
+    case op_c_beqz:
+    case op_c_bnez:
+    case op_c_j:
+    case op_c_jal:
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+// "L_" AND THE HEX DIGITS OF address, RETURN THE END
+static char *label_name(char *tmp_ptr, uint64_t address) {
+    *tmp_ptr++ = 'L';
+    *tmp_ptr++ = '_';
+    return text_hex(tmp_ptr, address, 1);
+}
+
+// WHAT print_decoded() ADDS TO A PLAIN LISTING LINE, labels AND symbols MAY BE NULL
+typedef struct {
+    const label_set *labels;
+    symbol_table *symbols;
+    // PRINT PSEUDO-INSTRUCTIONS, held - auipc WAITING FOR THE COMMAND AFTER IT, print_noted() ONLY
+    uint8_t pseudo;
+    uint8_t has_held;
+    command_data held;
+} listing_notes;
+
+// "name" OR "name+0x1c" FOR address INSIDE sym, RETURN THE END
+static char *symbol_name(char *tmp_ptr, const symbol_table *symbols, const symbol *sym, uint64_t address) {
+    const char *read_ptr = (*symbols).names + (*sym).name;
+
+    while (*read_ptr) {
+        *tmp_ptr++ = *read_ptr++;
+    }
+    if (address != (*sym).start) {
+        *tmp_ptr++ = '+';
+        *tmp_ptr++ = '0';
+        *tmp_ptr++ = 'x';
+        tmp_ptr = text_hex(tmp_ptr, address - (*sym).start, 1);
+    }
+    return tmp_ptr;
+}
+
+// target OF A JUMP OR BRANCH AS A SYMBOL OR LABEL, tmp_ptr UNCHANGED IF IT IS NEITHER
+// CALLS AND JUMPS PREFER THE SYMBOL WHEN IT STARTS AT target, THE LABEL WHEN IT IS INSIDE IT
+static char *note_target(char *tmp_ptr, const listing_notes *notes, uint16_t opcode, uint64_t target) {
+    const symbol *sym = NULL;
+
+    if ((*notes).symbols != NULL && (opcode == op_jal || opcode == op_c_jal || opcode == op_c_j)) {
+        sym = symbol_find((*notes).symbols, target);
+    }
+    if (sym != NULL && (*sym).start == target) {
+        return symbol_name(tmp_ptr, (*notes).symbols, sym, target);
+    }
+    if ((*notes).labels != NULL && label_set_has((*notes).labels, target)) {
+        return label_name(tmp_ptr, target);
+    }
+    if (sym != NULL) {
+        return symbol_name(tmp_ptr, (*notes).symbols, sym, target);
+    }
+    return tmp_ptr;
+}
+
+//================================================================
+//===================== Pseudo-Instructions ======================
+//================================================================
+
+static uint8_t pseudo_set(const char **name, const char **fmt, const char *pseudo_name, const char *pseudo_fmt) {
+    *name = pseudo_name;
+    *fmt = pseudo_fmt;
+    return 1;
+}
+
+// REPLACE *name AND *fmt OF cd BY THOSE OF THE ASSEMBLER PSEUDO-INSTRUCTION IT IS, 0 IF IT IS NONE
+static uint8_t pseudo_alias(const command_data *cd, const char **name, const char **fmt) {
+    uint8_t rd = (*cd).rd;
+    uint8_t rs1 = (*cd).rs1;
+    uint8_t rs2 = (*cd).rs2;
+    int32_t imm = (*cd).imm;
+
+    switch ((*cd).opcode) {
+    case op_addi:
+    case op_c_addi:
+    case op_c_li:
+        if (rd == rv_reg_zero && rs1 == rv_reg_zero && imm == 0) {
+            return pseudo_set(name, fmt, "nop", rv_fmt_none);
+        }
+        if (rs1 == rv_reg_zero) {
+            return pseudo_set(name, fmt, "li", rv_fmt_rd_imm);
+        }
+        if (imm == 0) {
+            return pseudo_set(name, fmt, "mv", rv_fmt_rd_rs1);
+        }
+        break;
+    case op_addiw:
+    case op_c_addiw:
+        if (imm == 0) {
+            return pseudo_set(name, fmt, "sext.w", rv_fmt_rd_rs1);
+        }
+        break;
+    case op_xori:
+        if (imm == -1) {
+            return pseudo_set(name, fmt, "not", rv_fmt_rd_rs1);
+        }
+        break;
+    case op_sub:
+        if (rs1 == rv_reg_zero) {
+            return pseudo_set(name, fmt, "neg", rv_fmt_rd_rs2);
+        }
+        break;
+    case op_subw:
+        if (rs1 == rv_reg_zero) {
+            return pseudo_set(name, fmt, "negw", rv_fmt_rd_rs2);
+        }
+        break;
+    case op_sltiu:
+        if (imm == 1) {
+            return pseudo_set(name, fmt, "seqz", rv_fmt_rd_rs1);
+        }
+        break;
+    case op_sltu:
+        if (rs1 == rv_reg_zero) {
+            return pseudo_set(name, fmt, "snez", rv_fmt_rd_rs2);
+        }
+        break;
+    case op_slt:
+        if (rs2 == rv_reg_zero) {
+            return pseudo_set(name, fmt, "sltz", rv_fmt_rd_rs1);
+        }
+        if (rs1 == rv_reg_zero) {
+            return pseudo_set(name, fmt, "sgtz", rv_fmt_rd_rs2);
+        }
+        break;
+    case op_beq:
+        if (rs2 == rv_reg_zero) {
+            return pseudo_set(name, fmt, "beqz", rv_fmt_rs1_offset);
+        }
+        break;
+    case op_bne:
+        if (rs2 == rv_reg_zero) {
+            return pseudo_set(name, fmt, "bnez", rv_fmt_rs1_offset);
+        }
+        break;
+    case op_blt:
+        if (rs2 == rv_reg_zero) {
+            return pseudo_set(name, fmt, "bltz", rv_fmt_rs1_offset);
+        }
+        if (rs1 == rv_reg_zero) {
+            return pseudo_set(name, fmt, "bgtz", rv_fmt_rs2_offset);
+        }
+        break;
+    case op_bge:
+        if (rs2 == rv_reg_zero) {
+            return pseudo_set(name, fmt, "bgez", rv_fmt_rs1_offset);
+        }
+        if (rs1 == rv_reg_zero) {
+            return pseudo_set(name, fmt, "blez", rv_fmt_rs2_offset);
+        }
+        break;
+    case op_jal:
+        if (rd == rv_reg_zero) {
+            return pseudo_set(name, fmt, "j", rv_fmt_offset);
+        }
+        if (rd == rv_reg_ra) {
+            return pseudo_set(name, fmt, "jal", rv_fmt_offset);
+        }
+        break;
+    case op_jalr:
+    case op_c_jalr:
+        if (rd == rv_reg_zero && rs1 == rv_reg_ra && imm == 0) {
+            return pseudo_set(name, fmt, "ret", rv_fmt_none);
+        }
+        if (rd == rv_reg_zero && imm == 0) {
+            return pseudo_set(name, fmt, "jr", rv_fmt_rs1);
+        }
+        if (rd == rv_reg_ra && imm == 0) {
+            return pseudo_set(name, fmt, "jalr", rv_fmt_rs1);
+        }
+        break;
+    case op_c_jr:
+        if (rs1 == rv_reg_ra) {
+            return pseudo_set(name, fmt, "ret", rv_fmt_none);
+        }
+        break;
+    case op_csrrs:
+        if (rs1 == rv_reg_zero) {
+            return pseudo_set(name, fmt, "csrr", rv_fmt_rd_csr);
+        }
+        if (rd == rv_reg_zero) {
+            return pseudo_set(name, fmt, "csrs", rv_fmt_csr_rs1);
+        }
+        break;
+    case op_csrrw:
+        if (rd == rv_reg_zero) {
+            return pseudo_set(name, fmt, "csrw", rv_fmt_csr_rs1);
+        }
+        break;
+    case op_csrrc:
+        if (rd == rv_reg_zero) {
+            return pseudo_set(name, fmt, "csrc", rv_fmt_csr_rs1);
+        }
+        break;
+    case op_csrrwi:
+        if (rd == rv_reg_zero) {
+            return pseudo_set(name, fmt, "csrwi", rv_fmt_csr_zimm);
+        }
+        break;
+    case op_csrrsi:
+        if (rd == rv_reg_zero) {
+            return pseudo_set(name, fmt, "csrsi", rv_fmt_csr_zimm);
+        }
+        break;
+    case op_csrrci:
+        if (rd == rv_reg_zero) {
+            return pseudo_set(name, fmt, "csrci", rv_fmt_csr_zimm);
+        }
+        break;
+    case op_fsgnj_s:
+        if (rs1 == rs2) {
+            return pseudo_set(name, fmt, "fmv.s", rv_fmt_frd_frs1);
+        }
+        break;
+    case op_fsgnjn_s:
+        if (rs1 == rs2) {
+            return pseudo_set(name, fmt, "fneg.s", rv_fmt_frd_frs1);
+        }
+        break;
+    case op_fsgnjx_s:
+        if (rs1 == rs2) {
+            return pseudo_set(name, fmt, "fabs.s", rv_fmt_frd_frs1);
+        }
+        break;
+    case op_fsgnj_d:
+        if (rs1 == rs2) {
+            return pseudo_set(name, fmt, "fmv.d", rv_fmt_frd_frs1);
+        }
+        break;
+    case op_fsgnjn_d:
+        if (rs1 == rs2) {
+            return pseudo_set(name, fmt, "fneg.d", rv_fmt_frd_frs1);
+        }
+        break;
+    case op_fsgnjx_d:
+        if (rs1 == rs2) {
+            return pseudo_set(name, fmt, "fabs.d", rv_fmt_frd_frs1);
+        }
+        break;
+    case op_fsgnj_q:
+        if (rs1 == rs2) {
+            return pseudo_set(name, fmt, "fmv.q", rv_fmt_frd_frs1);
+        }
+        break;
+    case op_fsgnjn_q:
+        if (rs1 == rs2) {
+            return pseudo_set(name, fmt, "fneg.q", rv_fmt_frd_frs1);
+        }
+        break;
+    case op_fsgnjx_q:
+        if (rs1 == rs2) {
+            return pseudo_set(name, fmt, "fabs.q", rv_fmt_frd_frs1);
+        }
+        break;
+    case op_fsgnj_h:
+        if (rs1 == rs2) {
+            return pseudo_set(name, fmt, "fmv.h", rv_fmt_frd_frs1);
+        }
+        break;
+    case op_fsgnjn_h:
+        if (rs1 == rs2) {
+            return pseudo_set(name, fmt, "fneg.h", rv_fmt_frd_frs1);
+        }
+        break;
+    case op_fsgnjx_h:
+        if (rs1 == rs2) {
+            return pseudo_set(name, fmt, "fabs.h", rv_fmt_frd_frs1);
+        }
+        break;
+    default:
+        break;
+    }
+    return 0;
+}
+
+//================================================================
+//======================== Output Sink ===========================
+//================================================================
+
+#define OUT_BUF_SIZE    (1 << 20)
+#define OUT_MAP_SIZE    (1 << 24)
+// LONGEST LINE print_decoded() CAN PRODUCE
+#define OUT_LINE_MAX    256
+
+// BUFFERED write(2) TO fd
+uint8_t out_open_fd(out_sink *out, int fd) {
+    memset(out, 0, sizeof(*out));
+    (*out).fd = fd;
+    if (((*out).buf = malloc(OUT_BUF_SIZE)) == NULL) {
+        goto error;
+    }
+    (*out).size = OUT_BUF_SIZE;
+    return 0;
+
+    error:
+    return 1;
+}
+
+// GROWING MEMORY BUFFER, NEVER FLUSHED
+uint8_t out_open_mem(out_sink *out, size_t size) {
+    memset(out, 0, sizeof(*out));
+    (*out).fd = -1;
+    if (((*out).buf = malloc(size)) == NULL) {
+        goto error;
+    }
+    (*out).size = size;
+    return 0;
+
+    error:
+    return 1;
+}
+
+// LINES GO STRAIGHT INTO THE MAPPED FILE, GROWN AS NEEDED AND TRIMMED ON CLOSE
+uint8_t out_open_map(out_sink *out, const char *path) {
+    memset(out, 0, sizeof(*out));
+    (*out).mapped = 1;
+    if (((*out).fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644)) < 0) {
+        goto error;
+    }
+    if (ftruncate((*out).fd, OUT_MAP_SIZE) != 0) {
+        goto error_close;
+    }
+    void *map = mmap(NULL, OUT_MAP_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, (*out).fd, 0);
+    if (map == MAP_FAILED) {
+        goto error_close;
+    }
+    (*out).buf = map;
+    (*out).size = OUT_MAP_SIZE;
+    return 0;
+
+    error_close:
+    close((*out).fd);
+    error:
+    return 1;
+}
+
+static uint8_t out_write_fd(int fd, const char *buf, size_t len) {
+    while (len > 0) {
+        ssize_t done = write(fd, buf, len);
+        if (done < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return 1;
+        }
+        buf += done;
+        len -= done;
+    }
+    return 0;
+}
+
+uint8_t out_flush(out_sink *out) {
+    if ((*out).mapped || (*out).fd < 0 || (*out).len == 0) {
+        return 0;
+    }
+    uint8_t err = out_write_fd((*out).fd, (*out).buf, (*out).len);
+    (*out).len = 0;
+    return err;
+}
+
+// MAKE ROOM FOR len MORE BYTES AT (*out).buf + (*out).len
+uint8_t out_reserve(out_sink *out, size_t len) {
+    if ((*out).len + len <= (*out).size) {
+        return 0;
+    }
+    size_t size = (*out).size ? (*out).size : OUT_LINE_MAX;
+    while (size < (*out).len + len) {
+        size *= 2;
+    }
+    if (!(*out).mapped && (*out).fd < 0) {
+        char *grown = realloc((*out).buf, size);
+        if (grown == NULL) {
+            return 1;
+        }
+        (*out).buf = grown;
+        (*out).size = size;
+        return 0;
+    }
+    if (!(*out).mapped) {
+        return out_flush(out) || len > (*out).size;
+    }
+    munmap((*out).buf, (*out).size);
+    (*out).buf = NULL;
+    if (ftruncate((*out).fd, size) != 0) {
+        goto error;
+    }
+    void *map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, (*out).fd, 0);
+    if (map == MAP_FAILED) {
+        goto error;
+    }
+    (*out).buf = map;
+    (*out).size = size;
+    return 0;
+
+    error:
+    (*out).size = 0;
+    return 1;
+}
+
+void out_write(out_sink *out, const char *str, size_t len) {
+    if (out_reserve(out, len) == 0) {
+        memcpy((*out).buf + (*out).len, str, len);
+        (*out).len += len;
+    }
+}
+
+void out_puts(out_sink *out, const char *str) {
+    out_write(out, str, strlen(str));
+}
+
+// "0x" AND AT LEAST digits LOWERCASE HEX DIGITS, LIKE "0x%.8lx"
+void out_hex(out_sink *out, uint64_t value, uint8_t digits) {
+    if (out_reserve(out, 2 + ((digits > 16) ? digits : 16)) == 0) {
+        char *tmp_ptr = (*out).buf + (*out).len;
+        *tmp_ptr++ = '0';
+        *tmp_ptr++ = 'x';
+        (*out).len = text_hex(tmp_ptr, value, (digits != 0) ? digits : 1) - (*out).buf;
+    }
+}
+
+void out_dec(out_sink *out, uint64_t value) {
+    if (out_reserve(out, 20) == 0) {
+        (*out).len = text_udec((*out).buf + (*out).len, value) - (*out).buf;
+    }
+}
+
+uint8_t out_close(out_sink *out) {
+    uint8_t err = 0;
+
+    if ((*out).mapped) {
+        if ((*out).buf != NULL) {
+            munmap((*out).buf, (*out).size);
+        }
+        err = ftruncate((*out).fd, (*out).len) != 0;
+        err |= close((*out).fd) != 0;
+    } else {
+        err = out_flush(out);
+        free((*out).buf);
+    }
+    memset(out, 0, sizeof(*out));
+    return err;
+}
+
+// Formatter op stream of a mnemonic and operand listing, fmt_literal is followed by a length byte and the text
+typedef enum {
+    fmt_end,
+    fmt_literal,
+    fmt_ireg_rd,
+    fmt_ireg_rs1,
+    fmt_ireg_rs2,
+    fmt_freg_rd,
+    fmt_freg_rs1,
+    fmt_freg_rs2,
+    fmt_freg_rs3,
+    fmt_zimm,
+    fmt_imm,
+    fmt_offset,
+    fmt_csr,
+    fmt_rm,
+    fmt_pred,
+    fmt_succ,
+} rv_fmt_op;
+
+// MNEMONICS ARE SHORTER THAN 32 (gen_opcodes), THE LONGEST LISTING ADDS 8 LITERAL BYTES AND 8 OPS
+#define FMT_PROGRAM_MAX 64
+
+static uint8_t opcode_program[sizeof(opcode_data) / sizeof(opcode_data[0])][FMT_PROGRAM_MAX];
+
+// COMPILE THE MNEMONIC name AND THE rv_fmt_ LISTING fmt INTO program, RUNS OF LITERAL TEXT MERGED
+static void format_compile(const char *name, const char *fmt, uint8_t *program) {
+    uint8_t *end = program + FMT_PROGRAM_MAX - 1;
+    uint8_t *literal = NULL;
+    uint8_t *pos = program;
+
+    for (; *fmt; fmt++) {
+        const char *text = fmt;
+        size_t len = 1;
+        uint8_t op = fmt_literal;
+        switch (*fmt) {
+        case 'O':
+            text = name;
+            len = strlen(name);
+            break;
+        case 'A':
+            text = ".aq";
+            len = 3;
+            break;
+        case 'R':
+            text = ".rl";
+            len = 3;
+            break;
+        case '(':
+        case ',':
+        case ')':
+        case '\t':
+            break;
+        case '0':
+            op = fmt_ireg_rd;
+            break;
+        case '1':
+            op = fmt_ireg_rs1;
+            break;
+        case '2':
+            op = fmt_ireg_rs2;
+            break;
+        case '3':
+            op = fmt_freg_rd;
+            break;
+        case '4':
+            op = fmt_freg_rs1;
+            break;
+        case '5':
+            op = fmt_freg_rs2;
+            break;
+        case '6':
+            op = fmt_freg_rs3;
+            break;
+        case '7':
+            op = fmt_zimm;
+            break;
+        case 'i':
+            op = fmt_imm;
+            break;
+        case 'o':
+            op = fmt_offset;
+            break;
+        case 'c':
+            op = fmt_csr;
+            break;
+        case 'r':
+            op = fmt_rm;
+            break;
+        case 'p':
+            op = fmt_pred;
+            break;
+        case 's':
+            op = fmt_succ;
+            break;
+        default:
+            continue;
+        }
+        if (op != fmt_literal) {
+            if (pos == end) {
+                break;
+            }
+            *pos++ = op;
+            literal = NULL;
+            continue;
+        }
+        if (literal == NULL) {
+            if (end - pos < 2) {
+                break;
+            }
+            literal = pos;
+            *pos++ = fmt_literal;
+            *pos++ = 0;
+        }
+        if ((size_t)(end - pos) < len || literal[1] + len > UINT8_MAX) {
+            break;
+        }
+        memcpy(pos, text, len);
+        pos += len;
+        literal[1] += len;
+    }
+    *pos = fmt_end;
+}
+
+static void format_init(void) {
+    for (size_t op = 0; op < sizeof(opcode_data) / sizeof(opcode_data[0]); op++) {
+        format_compile(opcode_data[op].name, opcode_data[op].format, opcode_program[op]);
+    }
+}
+
+// RUN program OF format_compile() OVER cd, WRITE THE TEXT TO tmp_ptr, RETURN THE END
+// LESS THAN OUT_LINE_MAX - 20 BYTES, NAMES ARE COPIED 4 BYTES AT A TIME SO UP TO 3 MORE ARE CLOBBERED
+// JUMP AND BRANCH TARGETS PRINT AS notes NAME THEM, notes MAY BE NULL
+static char *format_command(const command_data *cd, const uint8_t *program, char *tmp_ptr,
+    const listing_notes *notes)
+{
+    const rv_short_name *short_name;
+    const char *read_ptr;
+    uint8_t len;
+
+    while (1) {
+        switch (*program) {
+        case fmt_literal:
+            memcpy(tmp_ptr, program + 2, program[1]);
+            tmp_ptr += program[1];
+            program += 2 + program[1];
+            continue;
+        case fmt_ireg_rd:
+            short_name = &rv_ireg_name[(*cd).rd];
+            memcpy(tmp_ptr, (*short_name).text, 4);
+            tmp_ptr += (*short_name).len;
+            break;
+        case fmt_ireg_rs1:
+            short_name = &rv_ireg_name[(*cd).rs1];
+            memcpy(tmp_ptr, (*short_name).text, 4);
+            tmp_ptr += (*short_name).len;
+            break;
+        case fmt_ireg_rs2:
+            short_name = &rv_ireg_name[(*cd).rs2];
+            memcpy(tmp_ptr, (*short_name).text, 4);
+            tmp_ptr += (*short_name).len;
+            break;
+        case fmt_freg_rd:
+            short_name = &rv_freg_name[(*cd).rd];
+            memcpy(tmp_ptr, (*short_name).text, 4);
+            tmp_ptr += (*short_name).len;
+            break;
+        case fmt_freg_rs1:
+            short_name = &rv_freg_name[(*cd).rs1];
+            memcpy(tmp_ptr, (*short_name).text, 4);
+            tmp_ptr += (*short_name).len;
+            break;
+        case fmt_freg_rs2:
+            short_name = &rv_freg_name[(*cd).rs2];
+            memcpy(tmp_ptr, (*short_name).text, 4);
+            tmp_ptr += (*short_name).len;
+            break;
+        case fmt_freg_rs3:
+            short_name = &rv_freg_name[(*cd).rs3];
+            memcpy(tmp_ptr, (*short_name).text, 4);
+            tmp_ptr += (*short_name).len;
+            break;
+        case fmt_rm:
+            short_name = &rv_rm_name[(*cd).rm & 0b111];
+            memcpy(tmp_ptr, (*short_name).text, 4);
+            tmp_ptr += (*short_name).len;
+            break;
+        case fmt_zimm:
+            tmp_ptr = text_udec(tmp_ptr, (*cd).rs1);
+            break;
+        case fmt_imm:
+            tmp_ptr = text_dec(tmp_ptr, (*cd).imm);
+            break;
+        case fmt_offset:
+            if (notes != NULL && label_is_target((*cd).opcode)) {
+                char *note_end = note_target(tmp_ptr, notes, (*cd).opcode, (*cd).imm + (*cd).offset);
+                if (note_end != tmp_ptr) {
+                    tmp_ptr = note_end;
+                    break;
+                }
+            }
+            *tmp_ptr++ = '0';
+            *tmp_ptr++ = 'x';
+            tmp_ptr = text_hex(tmp_ptr, (*cd).imm + (*cd).offset, 1);
+            break;
+        case fmt_csr:
+            if ((len = csr_name((*cd).imm, &read_ptr)) != 0) {
+                memcpy(tmp_ptr, read_ptr, len);
+                tmp_ptr += len;
+            } else {
+                *tmp_ptr++ = '0';
+                *tmp_ptr++ = 'x';
+                tmp_ptr = text_hex(tmp_ptr, (*cd).imm & 0xfff, 3);
+            }
+            break;
+        case fmt_pred:
+            if ((*cd).pred & rv_fence_i) {
+                *tmp_ptr = 'i';
+                tmp_ptr++;
+            }
+            if ((*cd).pred & rv_fence_o) {
+                *tmp_ptr = 'o';
+                tmp_ptr++;
+            }
+            if ((*cd).pred & rv_fence_r) {
+                *tmp_ptr = 'r';
+                tmp_ptr++;
+            }
+            if ((*cd).pred & rv_fence_w) {
+                *tmp_ptr = 'W';
+                tmp_ptr++;
+            }
+            break;
+        case fmt_succ:
+            if ((*cd).succ & rv_fence_i) {
+                *tmp_ptr = 'i';
+                tmp_ptr++;
+            }
+            if ((*cd).succ & rv_fence_o) {
+                *tmp_ptr = 'o';
+                tmp_ptr++;
+            }
+            if ((*cd).succ & rv_fence_r) {
+                *tmp_ptr = 'r';
+                tmp_ptr++;
+            }
+            if ((*cd).succ & rv_fence_w) {
+                *tmp_ptr = 'w';
+                tmp_ptr++;
+            }
+            break;
+        default:
+            return tmp_ptr;
+        }
+        program++;
+    }
+}
+
+// "OFFSET\tCOMMAND" LINE, WITH notes THE OFFSET IS FOLLOWED BY " <symbol+0x1c>"
+static void print_line(out_sink *out, const command_data *cd, const uint8_t *program,
+    const listing_notes *notes)
+{
+    size_t reserve = OUT_LINE_MAX;
+
+    if (notes != NULL && (*notes).symbols != NULL) {
+        reserve += 2 * (*(*notes).symbols).longest_name;
+    }
+    if (out_reserve(out, reserve)) {
+        return;
+    }
+    char *tmp_ptr = (*out).buf + (*out).len;
+    *tmp_ptr++ = '0';
+    *tmp_ptr++ = 'x';
+    tmp_ptr = text_hex(tmp_ptr, (*cd).offset, 8);
+    if (notes != NULL && (*notes).symbols != NULL) {
+        const symbol *sym = symbol_at((*notes).symbols, (*cd).offset);
+        if (sym != NULL) {
+            *tmp_ptr++ = ' ';
+            *tmp_ptr++ = '<';
+            tmp_ptr = symbol_name(tmp_ptr, (*notes).symbols, sym, (*cd).offset);
+            *tmp_ptr++ = '>';
+        }
+    }
+    *tmp_ptr = '\t';
+    tmp_ptr = format_command(cd, program, tmp_ptr + 1, notes);
+    *tmp_ptr = '\n';
+    tmp_ptr++;
+    (*out).len = tmp_ptr - (*out).buf;
+}
+
+// A PSEUDO-INSTRUCTION IS COMPILED AS IT IS PRINTED, EVERY OTHER COMMAND RUNS ITS opcode_program[]
+static void print_decoded(out_sink *out, const command_data *cd, const listing_notes *notes)
+{
+    uint8_t program[FMT_PROGRAM_MAX];
+    const char *name;
+    const char *fmt;
+
+    if (notes != NULL && (*notes).pseudo && pseudo_alias(cd, &name, &fmt)) {
+        format_compile(name, fmt, program);
+        print_line(out, cd, program, notes);
+        return;
+    }
+    print_line(out, cd, opcode_program[(*cd).opcode], notes);
+}
+
+// PRINT THE auipc print_noted() HELD BACK, BEFORE ANY LINE THAT IS NOT A COMMAND
+static void pseudo_flush(out_sink *out, listing_notes *notes) {
+    if ((*notes).has_held) {
+        (*notes).has_held = 0;
+        print_decoded(out, &(*notes).held, notes);
+    }
+}
+
+// print_decoded() THAT PRINTS auipc AND THE addi OR jalr AFTER IT AS ONE la, call OR tail LINE
+// AN auipc IS HELD BACK UNTIL THE NEXT COMMAND SHOWS WHETHER IT PAIRS
+static void print_noted(out_sink *out, const command_data *cd, listing_notes *notes)
+{
+    if (!(*notes).pseudo) {
+        print_decoded(out, cd, notes);
+        return;
+    }
+    if ((*notes).has_held) {
+        const command_data *held = &(*notes).held;
+        uint8_t reg = (*held).rd;
+        command_data fused = *held;
+        const char *name = NULL;
+        const char *fmt = rv_fmt_offset;
+        fused.imm = (*held).imm + (*cd).imm;
+        if ((*cd).offset == (*held).offset + 4 && reg != rv_reg_zero && (*cd).rs1 == reg) {
+            if ((*cd).opcode == op_addi && (*cd).rd == reg) {
+                name = "la";
+                fmt = rv_fmt_rd_offset;
+            } else if ((*cd).opcode == op_jalr && (*cd).rd == rv_reg_ra) {
+                name = "call";
+                fused.opcode = op_jal;
+            } else if ((*cd).opcode == op_jalr && (*cd).rd == rv_reg_zero && reg == rv_reg_t1) {
+                name = "tail";
+                fused.opcode = op_jal;
+            }
+        }
+        (*notes).has_held = 0;
+        if (name != NULL) {
+            uint8_t program[FMT_PROGRAM_MAX];
+            format_compile(name, fmt, program);
+            print_line(out, &fused, program, notes);
+            return;
+        }
+        print_decoded(out, held, notes);
+    }
+    if ((*cd).opcode == op_auipc) {
+        (*notes).held = *cd;
+        (*notes).has_held = 1;
+        return;
+    }
+    print_decoded(out, cd, notes);
+}
+
+//================================================================
+//===================== Command Processing =======================
+//================================================================
+
+// RUN THE DECODER decode_command() DIDN'T USE ON cd, REPORT A DISAGREEMENT
+// 16-BIT PARCELS ARE CHECKED AGAINST bp_opcode(), 32-BIT WORDS AGAINST THE GENERATED TABLES
+static uint32_t decoder_mismatch(out_sink *out, const command_data *cd) {
+    command_data check = *cd;
+    uint8_t rvc = ((*cd).byte_data & 0b11) != 0b11;
+
+    if (rvc) {
+        bp_opcode(&check);
+    } else {
+        bp_opcode_table(&check);
+    }
+    if (check.opcode == (*cd).opcode) {
+        return 0;
+    }
+    // THE SWITCH NAME FIRST, THE TABLE NAME SECOND
+    char tmp[80];
+    snprintf(tmp, sizeof(tmp), "ERROR: DECODER MISMATCH 0x%08x\t%s\t%s\n", (*cd).byte_data,
+        opcode_data[rvc ? check.opcode : (*cd).opcode].name, opcode_data[rvc ? (*cd).opcode : check.opcode].name);
+    out_puts(out, tmp);
+    return 1;
+}
+
+// DECODE AND PRINT THE COMMAND FETCHED INTO cd BY table OF ITS WIDTH, RETURN 1 ON DECODER MISMATCH
+static uint32_t disasm_command(out_sink *out, code_span *span, command_data *cd, const rv_decode_table *table,
+    uint8_t check_decoder) {
+    uint32_t mismatch = 0;
+
+    if ((*span).segment_end) {
+        out_puts(out, "================END OF SEGMENT================\n");
+        (*span).segment_end = 0;
+    }
+    decode_command(table, cd);
+    if (check_decoder) {
+        mismatch = decoder_mismatch(out, cd);
+    }
+    print_decoded(out, cd, NULL);
+    return mismatch;
+}
+
+// LISTING OF segment FROM start TO THE END MARKER OR SEGMENT END ON THIS THREAD
+uint32_t disasm_serial(out_sink *out, const hex_segment *segment, size_t start, uint8_t pc,
+    uint8_t check_decoder) {
+    code_span span;
+    command_data cd;
+    uint32_t mismatches = 0;
+    const rv_decode_table *table = &decode_tables[pc];
+
+    span.data = (*segment).data;
+    span.size = (*segment).size;
+    span.base = (*segment).base;
+    span.pos = start;
+    span.destruct_flag = 0;
+    span.segment_end = 0;
+    cd.pc = pc;
+
+    cd.offset = span.base + span.pos;
+    while ((cd.byte_data = get_next_command(&span)) != 0)
+    {
+        mismatches += disasm_command(out, &span, &cd, table, check_decoder);
+        cd.offset = span.base + span.pos;
+    }
+    return mismatches;
+}
+
+// LISTING OF THE COMMANDS OF segment STARTING IN [start, end), THE END MARKER IS NOT APPLIED
+uint32_t disasm_range(out_sink *out, const hex_segment *segment, size_t start, size_t end, uint8_t pc,
+    uint8_t check_decoder) {
+    code_span span;
+    command_data cd;
+    uint32_t mismatches = 0;
+    const rv_decode_table *table = &decode_tables[pc];
+
+    span.data = (*segment).data;
+    span.size = (*segment).size;
+    span.base = (*segment).base;
+    span.pos = start;
+    span.segment_end = 0;
+    cd.pc = pc;
+
+    while (span.pos < end) {
+        cd.offset = span.base + span.pos;
+        span.destruct_flag = 0;
+        if ((cd.byte_data = get_next_command(&span)) == 0) {
+            break;
+        }
+        mismatches += disasm_command(out, &span, &cd, table, check_decoder);
+    }
+    return mismatches;
+}
+
+// COMMANDS disasm_range() WOULD LIST, OR disasm_serial() IF end IS (size_t)-1
+// *cmds IS malloc'ed, THE CALLER FREES IT
+uint8_t disasm_collect_linear(const hex_segment *segment, size_t start, size_t end, uint8_t pc,
+    command_data **cmds, size_t *num_of_cmds) {
+    code_span span;
+    command_data cd;
+    size_t capacity = 0;
+    const rv_decode_table *table = &decode_tables[pc];
+
+    span.data = (*segment).data;
+    span.size = (*segment).size;
+    span.base = (*segment).base;
+    span.pos = start;
+    span.destruct_flag = 0;
+    span.segment_end = 0;
+    cd.pc = pc;
+    *cmds = NULL;
+    *num_of_cmds = 0;
+
+    while (span.pos < end) {
+        cd.offset = span.base + span.pos;
+        if (end != (size_t)-1) {
+            span.destruct_flag = 0;
+        }
+        if ((cd.byte_data = get_next_command(&span)) == 0) {
+            break;
+        }
+        decode_command(table, &cd);
+        if (*num_of_cmds == capacity) {
+            capacity = capacity ? 2 * capacity : 4096;
+            command_data *grown = realloc(*cmds, capacity * sizeof(command_data));
+            if (grown == NULL) {
+                goto error;
+            }
+            *cmds = grown;
+        }
+        (*cmds)[(*num_of_cmds)++] = cd;
+    }
+    return 0;
+
+    error:
+    free(*cmds);
+    *cmds = NULL;
+    *num_of_cmds = 0;
+    return 1;
+}
+
+//================================================================
+//======================== Batch Decode ==========================
+//================================================================
+
+void disasm_init(void) {
+    hex_record_init();
+    rvc_records_init();
+    format_init();
+}
+
+// HOT-WORD CACHE OF THE CALLING THREAD, num_of_entries ROUNDED UP TO A POWER OF 2, 0 - OFF
+// COUNTERS START FROM 0, disasm_parallel() WORKERS ADD THEIRS TO THOSE OF THE CALLER
+uint8_t decode_cache_enable(uint32_t num_of_entries) {
+    uint8_t bits = DECODE_MEMO_MIN_BITS;
+
+    free(decode_memo.entry);
+    memset(&decode_memo, 0, sizeof(decode_memo));
+    if (num_of_entries == 0) {
+        return 0;
+    }
+    while (bits < DECODE_MEMO_MAX_BITS && (1u << bits) < num_of_entries) {
+        bits++;
+    }
+    if ((decode_memo.entry = calloc(1u << bits, sizeof(rv_memo_entry))) == NULL) {
+        goto error;
+    }
+    decode_memo.shift = 32 - bits;
+    return 0;
+
+    error:
+    return 1;
+}
+
+// ENTRIES OF THE CACHE OF THE CALLING THREAD, 0 IF IT IS OFF
+uint32_t decode_cache_size(void) {
+    return (decode_memo.entry != NULL) ? 1u << (32 - decode_memo.shift) : 0;
+}
+
+void decode_cache_stats(uint64_t *hits, uint64_t *misses) {
+    *hits = decode_memo.hits;
+    *misses = decode_memo.misses;
+}
+
+// DECODE THE COMMAND AT ptr INTO cd BY table OF ITS WIDTH, RETURN ITS LENGTH OR 0 IF left BYTES CUT IT
+static uint8_t decode_next(const uint8_t *ptr, size_t left, const rv_decode_table *table, command_data *cd) {
+    uint8_t length;
+
+    if (left < 2) {
+        return 0;
+    }
+    if ((ptr[0] & 0b11) != 0b11) {
+        (*cd).byte_data = ptr[0] | (ptr[1] << 8);
+        length = 2;
+    } else {
+        if (left < 4) {
+            return 0;
+        }
+        (*cd).byte_data = ptr[0] | (ptr[1] << 8) | (ptr[2] << 16) | ((uint32_t)ptr[3] << 24);
+        length = 4;
+    }
+    decode_command(table, cd);
+    return length;
+}
+
+// DECODE UP TO max_cmds COMMANDS OF data LOADED AT address INTO cmds
+// NO END MARKER OR ZERO PARCEL HANDLING, STOPS BEFORE A COMMAND CUT BY THE END OF data
+// RETURNS THE NUMBER OF COMMANDS, *used (IF NOT NULL) - BYTES THEY TAKE
+size_t disasm_decode(const uint8_t *data, size_t size, uint64_t address, uint8_t pc,
+    command_data *cmds, size_t max_cmds, size_t *used) {
+    size_t pos = 0;
+    size_t n = 0;
+    uint8_t length;
+    const rv_decode_table *table = &decode_tables[pc];
+
+    while (n < max_cmds) {
+        command_data *cd = &cmds[n];
+
+        (*cd).offset = address + pos;
+        (*cd).pc = pc;
+        if ((length = decode_next(data + pos, size - pos, table, cd)) == 0) {
+            break;
+        }
+        pos += length;
+        n++;
+    }
+    if (used != NULL) {
+        *used = pos;
+    }
+    return n;
+}
+
+#define BATCH_ALIGN         64
+#define BATCH_ROUND(bytes)  (((bytes) + BATCH_ALIGN - 1) & ~(size_t)(BATCH_ALIGN - 1))
+
+static void *batch_carve(uint8_t **block, size_t bytes) {
+    void *ptr = *block;
+    *block += BATCH_ROUND(bytes);
+    return ptr;
+}
+
+// ALL ARRAYS IN ONE BLOCK, EACH STARTING ON ITS OWN CACHE LINE
+uint8_t command_batch_init(command_batch *batch, size_t capacity) {
+    size_t size = 2 * BATCH_ROUND(capacity * sizeof(uint32_t)) + 2 * BATCH_ROUND(capacity * sizeof(uint16_t)) +
+        5 * BATCH_ROUND(capacity);
+    uint8_t *block;
+
+    memset(batch, 0, sizeof(*batch));
+    if (posix_memalign((void **)&block, BATCH_ALIGN, size ? size : BATCH_ALIGN) != 0) {
+        goto error;
+    }
+    (*batch).offset = batch_carve(&block, capacity * sizeof(uint32_t));
+    (*batch).imm = batch_carve(&block, capacity * sizeof(int32_t));
+    (*batch).opcode = batch_carve(&block, capacity * sizeof(uint16_t));
+    (*batch).attr = batch_carve(&block, capacity * sizeof(uint16_t));
+    (*batch).rd = batch_carve(&block, capacity);
+    (*batch).rs1 = batch_carve(&block, capacity);
+    (*batch).rs2 = batch_carve(&block, capacity);
+    (*batch).rs3 = batch_carve(&block, capacity);
+    (*batch).length = batch_carve(&block, capacity);
+    (*batch).capacity = capacity;
+    return 0;
+
+    error:
+    return 1;
+}
+
+void command_batch_free(command_batch *batch) {
+    free((*batch).offset);
+    memset(batch, 0, sizeof(*batch));
+}
+
+// LIKE disasm_decode() BUT INTO THE ARRAYS OF batch, UP TO ITS CAPACITY
+// ONE BATCH COVERS LESS THAN 4 GiB SO OFFSETS ARE KEPT RELATIVE TO (*batch).base
+size_t disasm_decode_batch(const uint8_t *data, size_t size, uint64_t address, uint8_t pc,
+    command_batch *batch, size_t *used) {
+    command_data cd;
+    size_t pos = 0;
+    size_t n = 0;
+    uint8_t length;
+    const rv_decode_table *table = &decode_tables[pc];
+
+    if (size > UINT32_MAX) {
+        size = UINT32_MAX;
+    }
+    (*batch).base = address;
+    (*batch).pc = pc;
+    cd.pc = pc;
+    while (n < (*batch).capacity) {
+        cd.offset = address + pos;
+        if ((length = decode_next(data + pos, size - pos, table, &cd)) == 0) {
+            break;
+        }
+        (*batch).offset[n] = pos;
+        (*batch).opcode[n] = cd.opcode;
+        (*batch).imm[n] = cd.imm;
+        (*batch).attr[n] = BATCH_ATTR(cd.rm, cd.aq, cd.rl, cd.pred, cd.succ);
+        (*batch).rd[n] = cd.rd;
+        (*batch).rs1[n] = cd.rs1;
+        (*batch).rs2[n] = cd.rs2;
+        (*batch).rs3[n] = cd.rs3;
+        (*batch).length[n] = length;
+        pos += length;
+        n++;
+    }
+    (*batch).num_of_cmds = n;
+    if (used != NULL) {
+        *used = pos;
+    }
+    return n;
+}
+
+// REBUILD command_data OF COMMAND i, byte_data IS NOT KEPT AND STAYS 0
+void command_batch_get(const command_batch *batch, size_t i, command_data *cd) {
+    uint16_t attr = (*batch).attr[i];
+
+    (*cd).offset = (*batch).base + (*batch).offset[i];
+    (*cd).pc = (*batch).pc;
+    (*cd).opcode = (*batch).opcode[i];
+    (*cd).byte_data = 0;
+    (*cd).imm = (*batch).imm[i];
+    (*cd).rd = (*batch).rd[i];
+    (*cd).rs1 = (*batch).rs1[i];
+    (*cd).rs2 = (*batch).rs2[i];
+    (*cd).rs3 = (*batch).rs3[i];
+    (*cd).rm = attr & 0x7;
+    (*cd).aq = (attr >> 3) & 1;
+    (*cd).rl = (attr >> 4) & 1;
+    (*cd).pred = (attr >> 5) & 0xf;
+    (*cd).succ = (attr >> 9) & 0xf;
+}
+
+// TEXT OF ONE DECODED COMMAND WITHOUT THE OFFSET, CUT TO size - 1 CHARS
+// RETURNS THE FULL LENGTH LIKE snprintf
+size_t disasm_format(const command_data *cd, char *buf, size_t size) {
+    char tmp[OUT_LINE_MAX];
+    size_t len = format_command(cd, opcode_program[(*cd).opcode], tmp, NULL) - tmp;
+
+    if (size > 0) {
+        size_t copy = (len < size) ? len : size - 1;
+        memcpy(buf, tmp, copy);
+        buf[copy] = '\0';
+    }
+    return len;
+}
+
+// LISTING LINES "OFFSET\tCOMMAND" OF num_of_cmds DECODED COMMANDS
+void disasm_print(out_sink *out, const command_data *cmds, size_t num_of_cmds) {
+    for (size_t i = 0; i < num_of_cmds; i++) {
+        print_decoded(out, &cmds[i], NULL);
+    }
+}
+
+void disasm_print_batch(out_sink *out, const command_batch *batch) {
+    command_data cd;
+
+    for (size_t i = 0; i < (*batch).num_of_cmds; i++) {
+        command_batch_get(batch, i, &cd);
+        print_decoded(out, &cd, NULL);
+    }
+}
+
+//================================================================
+//===================== Parallel Disassembly =====================
+//================================================================
+
+#define PAR_MIN_CHUNK       4096
+#define PAR_MAX_CHUNK       (1 << 20)
+// CHUNKS PER THREAD, ALSO BOUNDS HOW FAR WORKERS RUN AHEAD OF THE STITCHER
+#define PAR_CHUNKS_AHEAD    8
+
+enum {
+    par_chunk_pending,
+    par_chunk_claimed,
+    par_chunk_done
+};
+
+// SPECULATIVELY DECODED [begin, end) OF THE SEGMENT, ASSUMING A COMMAND STARTS AT begin
+typedef struct {
+    size_t begin;
+    size_t end;
+    // POSITION AFTER THE LAST DECODED COMMAND, MAY PASS end
+    size_t stop;
+    // START OF EVERY COMMAND RELATIVE TO begin AND OF ITS TEXT IN out, DECODER MISMATCHES BEFORE IT
+    uint32_t *cmd_pos;
+    uint32_t *line_pos;
+    uint32_t *mismatch_pos;
+    size_t num_of_cmds;
+    out_sink out;
+    uint8_t state;
+    uint8_t failed;
+} par_chunk;
+
+typedef struct {
+    const hex_segment *segment;
+    uint8_t pc;
+    uint8_t check_decoder;
+    par_chunk *chunk;
+    size_t num_of_chunks;
+    size_t next;
+    size_t window_end;
+    // decode_cache_size() OF THE CALLER, COUNTERS OF THE WORKERS
+    uint32_t cache_entries;
+    uint64_t cache_hits;
+    uint64_t cache_misses;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+} par_job;
+
+static void par_decode_chunk(par_job *job, par_chunk *chunk) {
+    code_span span;
+    command_data cd;
+    size_t capacity = ((*chunk).end - (*chunk).begin) / 2 + 2;
+    const rv_decode_table *table = &decode_tables[(*job).pc];
+
+    span.data = (*(*job).segment).data;
+    span.size = (*(*job).segment).size;
+    span.base = (*(*job).segment).base;
+    span.pos = (*chunk).begin;
+    span.destruct_flag = 0;
+    span.segment_end = 0;
+    cd.pc = (*job).pc;
+
+    (*chunk).cmd_pos = malloc(capacity * sizeof(uint32_t));
+    (*chunk).line_pos = malloc((capacity + 1) * sizeof(uint32_t));
+    (*chunk).mismatch_pos = malloc((capacity + 1) * sizeof(uint32_t));
+    if ((*chunk).cmd_pos == NULL || (*chunk).line_pos == NULL || (*chunk).mismatch_pos == NULL ||
+        out_open_mem(&(*chunk).out, 32 * capacity + OUT_LINE_MAX)) {
+        (*chunk).failed = 1;
+        return;
+    }
+    uint32_t mismatches = 0;
+    while (span.pos < (*chunk).end) {
+        size_t pos = span.pos;
+        cd.offset = span.base + pos;
+        // THE END MARKER DEPENDS ON THE PREVIOUS COMMAND, THE STITCHER APPLIES IT
+        span.destruct_flag = 0;
+        if ((cd.byte_data = get_next_command(&span)) == 0) {
+            break;
+        }
+        (*chunk).cmd_pos[(*chunk).num_of_cmds] = pos - (*chunk).begin;
+        (*chunk).line_pos[(*chunk).num_of_cmds] = (*chunk).out.len;
+        (*chunk).mismatch_pos[(*chunk).num_of_cmds] = mismatches;
+        (*chunk).num_of_cmds++;
+        mismatches += disasm_command(&(*chunk).out, &span, &cd, table, (*job).check_decoder);
+    }
+    (*chunk).line_pos[(*chunk).num_of_cmds] = (*chunk).out.len;
+    (*chunk).mismatch_pos[(*chunk).num_of_cmds] = mismatches;
+    (*chunk).stop = span.pos;
+}
+
+static void *par_worker(void *arg) {
+    par_job *job = arg;
+
+    // WITHOUT MEMORY FOR IT THE WORKER RUNS UNCACHED
+    decode_cache_enable((*job).cache_entries);
+    pthread_mutex_lock(&(*job).lock);
+    while (1) {
+        while ((*job).next < (*job).num_of_chunks && (*job).next >= (*job).window_end) {
+            pthread_cond_wait(&(*job).cond, &(*job).lock);
+        }
+        if ((*job).next >= (*job).num_of_chunks) {
+            break;
+        }
+        par_chunk *chunk = &(*job).chunk[(*job).next++];
+        (*chunk).state = par_chunk_claimed;
+        pthread_mutex_unlock(&(*job).lock);
+
+        par_decode_chunk(job, chunk);
+
+        pthread_mutex_lock(&(*job).lock);
+        (*chunk).state = par_chunk_done;
+        pthread_cond_broadcast(&(*job).cond);
+    }
+    (*job).cache_hits += decode_memo.hits;
+    (*job).cache_misses += decode_memo.misses;
+    pthread_mutex_unlock(&(*job).lock);
+    decode_cache_enable(0);
+    return NULL;
+}
+
+// INDEX OF THE CHUNK COMMAND STARTING AT pos OR num_of_cmds
+static size_t par_find_command(const par_chunk *chunk, size_t pos) {
+    size_t lo = 0;
+    size_t hi = (*chunk).num_of_cmds;
+
+    if ((*chunk).failed || pos < (*chunk).begin) {
+        return (*chunk).num_of_cmds;
+    }
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if ((*chunk).cmd_pos[mid] < pos - (*chunk).begin) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return (lo < (*chunk).num_of_cmds && (*chunk).cmd_pos[lo] == pos - (*chunk).begin) ? lo : (*chunk).num_of_cmds;
+}
+
+static void par_chunk_free(par_chunk *chunk) {
+    free((*chunk).cmd_pos);
+    free((*chunk).line_pos);
+    free((*chunk).mismatch_pos);
+    if ((*chunk).out.buf != NULL) {
+        out_close(&(*chunk).out);
+    }
+    (*chunk).cmd_pos = NULL;
+    (*chunk).line_pos = NULL;
+    (*chunk).mismatch_pos = NULL;
+}
+
+// DECODE FROM start TO THE END MARKER OR SEGMENT END ON num_of_threads THREADS
+// CHUNKS ARE DECODED FROM A GUESSED BOUNDARY; THE STITCHER KEEPS A CHUNK FROM THE
+// FIRST COMMAND THE PREVIOUS CHUNK REALLY ENDS ON AND DECODES SERIALLY UNTIL IT SYNCS
+uint32_t disasm_parallel(out_sink *out, const hex_segment *segment, size_t start, uint8_t pc,
+    uint8_t check_decoder, uint32_t num_of_threads) {
+    par_job job;
+    pthread_t *thread;
+    uint32_t mismatches = 0;
+    size_t region = (*segment).size - start;
+    size_t chunk_size = region / ((size_t)num_of_threads * PAR_CHUNKS_AHEAD);
+    const rv_decode_table *table = &decode_tables[pc];
+
+    if (chunk_size < PAR_MIN_CHUNK) {
+        chunk_size = PAR_MIN_CHUNK;
+    } else if (chunk_size > PAR_MAX_CHUNK) {
+        chunk_size = PAR_MAX_CHUNK;
+    }
+    chunk_size &= ~(size_t)1;
+
+    memset(&job, 0, sizeof(job));
+    job.segment = segment;
+    job.pc = pc;
+    job.check_decoder = check_decoder;
+    job.num_of_chunks = (region + chunk_size - 1) / chunk_size;
+    job.window_end = (size_t)num_of_threads * PAR_CHUNKS_AHEAD;
+    job.cache_entries = decode_cache_size();
+    job.chunk = calloc(job.num_of_chunks ? job.num_of_chunks : 1, sizeof(par_chunk));
+    thread = calloc(num_of_threads, sizeof(pthread_t));
+    if (job.chunk == NULL || thread == NULL) {
+        free(job.chunk);
+        free(thread);
+        return 1;
+    }
+    for (size_t k = 0; k < job.num_of_chunks; k++) {
+        job.chunk[k].begin = start + k * chunk_size;
+        job.chunk[k].end = (k + 1 == job.num_of_chunks) ? (*segment).size : start + (k + 1) * chunk_size;
+    }
+    pthread_mutex_init(&job.lock, NULL);
+    pthread_cond_init(&job.cond, NULL);
+    uint32_t num_of_started = 0;
+    while (num_of_started < num_of_threads &&
+        pthread_create(&thread[num_of_started], NULL, par_worker, &job) == 0) {
+        num_of_started++;
+    }
+
+    code_span span;
+    command_data cd;
+    span.data = (*segment).data;
+    span.size = (*segment).size;
+    span.base = (*segment).base;
+    span.pos = start;
+    span.destruct_flag = 0;
+    span.segment_end = 0;
+    cd.pc = pc;
+
+    uint8_t stopped = 0;
+    for (size_t k = 0; k < job.num_of_chunks; k++) {
+        par_chunk *chunk = &job.chunk[k];
+
+        pthread_mutex_lock(&job.lock);
+        if (num_of_started == 0 && (*chunk).state == par_chunk_pending) {
+            // NO WORKER THREADS, DECODE SERIALLY BELOW
+            (*chunk).failed = 1;
+            (*chunk).state = par_chunk_done;
+        }
+        while ((*chunk).state != par_chunk_done) {
+            pthread_cond_wait(&job.cond, &job.lock);
+        }
+        pthread_mutex_unlock(&job.lock);
+
+        while (!stopped && span.pos < (*chunk).end) {
+            size_t i = par_find_command(chunk, span.pos);
+            if (i == (*chunk).num_of_cmds) {
+                // NOT IN SYNC YET, TAKE ONE COMMAND SERIALLY
+                cd.offset = span.base + span.pos;
+                if ((cd.byte_data = get_next_command(&span)) == 0) {
+                    stopped = 1;
+                    break;
+                }
+                mismatches += disasm_command(out, &span, &cd, table, check_decoder);
+                continue;
+            }
+            // IN SYNC, KEEP THE REST OF THE CHUNK UP TO THE END MARKER
+            size_t j = i;
+            for (; j < (*chunk).num_of_cmds; j++) {
+                const uint8_t *ptr = span.data + (*chunk).begin + (*chunk).cmd_pos[j];
+                uint16_t parcel = ptr[0] | (ptr[1] << 8);
+                if (span.destruct_flag && parcel == 0b10) {
+                    stopped = 1;
+                    break;
+                }
+                span.destruct_flag = (parcel == 0b01);
+            }
+            out_write(out, (*chunk).out.buf + (*chunk).line_pos[i], (*chunk).line_pos[j] - (*chunk).line_pos[i]);
+            // ONLY THE KEPT COMMANDS COUNT, NOT THOSE BEFORE THE RESYNC OR PAST THE END MARKER
+            mismatches += (*chunk).mismatch_pos[j] - (*chunk).mismatch_pos[i];
+            span.pos = stopped ? (*chunk).begin + (*chunk).cmd_pos[j] : (*chunk).stop;
+            if (!stopped && (*chunk).stop < (*chunk).end) {
+                // SEGMENT ENDED INSIDE THE CHUNK
+                stopped = 1;
+            }
+        }
+        par_chunk_free(chunk);
+
+        pthread_mutex_lock(&job.lock);
+        job.window_end++;
+        if (stopped) {
+            job.next = job.num_of_chunks;
+        }
+        pthread_cond_broadcast(&job.cond);
+        pthread_mutex_unlock(&job.lock);
+        if (stopped) {
+            // WAIT FOR CLAIMED CHUNKS, FREE THE REST
+            for (size_t rest = k + 1; rest < job.num_of_chunks; rest++) {
+                pthread_mutex_lock(&job.lock);
+                while (job.chunk[rest].state == par_chunk_claimed) {
+                    pthread_cond_wait(&job.cond, &job.lock);
+                }
+                pthread_mutex_unlock(&job.lock);
+                par_chunk_free(&job.chunk[rest]);
+            }
+            break;
+        }
+    }
+
+    for (uint32_t t = 0; t < num_of_started; t++) {
+        pthread_join(thread[t], NULL);
+    }
+    decode_memo.hits += job.cache_hits;
+    decode_memo.misses += job.cache_misses;
+    pthread_cond_destroy(&job.cond);
+    pthread_mutex_destroy(&job.lock);
+    free(job.chunk);
+    free(thread);
+    return mismatches;
+}
+
+//================================================================
+//====================== Recursive Descent =======================
+//================================================================
+
+typedef struct {
+    const hex_image *image;
+    uint8_t pc;
+    // ONE BIT PER HALFWORD OF EVERY SEGMENT, SET ONCE A COMMAND WAS DECODED THERE
+    uint8_t **visited;
+    uint64_t *work;
+    size_t num_of_work;
+    size_t work_capacity;
+    command_data *cmds;
+    size_t num_of_cmds;
+    size_t cmds_capacity;
+} descent_state;
+
+static uint8_t descent_push(descent_state *ds, uint64_t address) {
+    if ((*ds).num_of_work == (*ds).work_capacity) {
+        size_t capacity = (*ds).work_capacity ? 2 * (*ds).work_capacity : 256;
+        uint64_t *grown = realloc((*ds).work, capacity * sizeof(uint64_t));
+        if (grown == NULL) {
+            return 1;
+        }
+        (*ds).work = grown;
+        (*ds).work_capacity = capacity;
+    }
+    (*ds).work[(*ds).num_of_work++] = address;
+    return 0;
+}
+
+// DECODE STRAIGHT FROM address UNTIL FLOW CAN'T FALL THROUGH, QUEUE EVERY DIRECT TARGET
+static uint8_t descent_walk(descent_state *ds, uint64_t address) {
+    command_data cd;
+    uint8_t length;
+    const rv_decode_table *table = &decode_tables[(*ds).pc];
+
+    cd.pc = (*ds).pc;
+    while (1) {
+        const hex_segment *segment = hex_image_find((*ds).image, address);
+        if (segment == NULL || (address & 1)) {
+            break;
+        }
+        uint8_t *visited = (*ds).visited[segment - (*(*ds).image).segment];
+        size_t pos = address - (*segment).base;
+        if (visited[pos >> 4] & (1 << ((pos >> 1) & 7))) {
+            break;
+        }
+        visited[pos >> 4] |= 1 << ((pos >> 1) & 7);
+        cd.offset = address;
+        // ZERO PARCELS ARE PADDING, ILLEGAL COMMANDS ARE DATA
+        if ((length = decode_next((*segment).data + pos, (*segment).size - pos, table, &cd)) == 0 ||
+            cd.byte_data == 0 || cd.opcode == op_illegal) {
+            break;
+        }
+        if ((*ds).num_of_cmds == (*ds).cmds_capacity) {
+            size_t capacity = (*ds).cmds_capacity ? 2 * (*ds).cmds_capacity : 4096;
+            command_data *grown = realloc((*ds).cmds, capacity * sizeof(command_data));
+            if (grown == NULL) {
+                return 1;
+            }
+            (*ds).cmds = grown;
+            (*ds).cmds_capacity = capacity;
+        }
+        (*ds).cmds[(*ds).num_of_cmds++] = cd;
+
+        switch (cd.opcode) {
+        case op_jal:
+        case op_c_jal:
+        case op_c_j:
+        case op_beq:
+        case op_bne:
+        case op_blt:
+        case op_bge:
+        case op_bltu:
+        case op_bgeu:
+        case op_c_beqz:
+        case op_c_bnez:
+            if (descent_push(ds, address + cd.imm)) {
+                return 1;
+            }
+            // jal WITHOUT A LINK REGISTER IS A PLAIN JUMP
+            if (cd.opcode == op_c_j || (cd.opcode == op_jal && cd.rd == rv_reg_zero)) {
+                return 0;
+            }
+            break;
+        case op_jalr:
+            if (cd.rd == rv_reg_zero) {
+                return 0;
+            }
+            break;
+        case op_c_jr:
+            return 0;
+        default:
+            break;
+        }
+        address += length;
+    }
+    return 0;
+}
+
+static int descent_cmd_cmp(const void *a, const void *b) {
+    uint64_t offset_a = (*(const command_data *)a).offset;
+    uint64_t offset_b = (*(const command_data *)b).offset;
+    return (offset_a > offset_b) - (offset_a < offset_b);
+}
+
+// COMMANDS REACHABLE FROM entry THROUGH jal/BRANCH TARGETS AND FALLTHROUGH, SORTED BY ADDRESS
+// INDIRECT JUMPS END A PATH, CALLS (jal/jalr WITH A LINK REGISTER) FALL THROUGH
+// *cmds IS malloc'ed, THE CALLER FREES IT
+uint8_t disasm_collect_reachable(const hex_image *image, uint64_t entry, uint8_t pc, command_data **cmds,
+    size_t *num_of_cmds) {
+    descent_state ds;
+    uint8_t err = 1;
+
+    memset(&ds, 0, sizeof(ds));
+    ds.image = image;
+    ds.pc = pc;
+    if ((ds.visited = calloc((*image).num_of_segments + 1, sizeof(uint8_t *))) == NULL) {
+        goto done;
+    }
+    for (size_t i = 0; i < (*image).num_of_segments; i++) {
+        if ((ds.visited[i] = calloc((*image).segment[i].size / 16 + 1, 1)) == NULL) {
+            goto done;
+        }
+    }
+    if (descent_push(&ds, entry)) {
+        goto done;
+    }
+    while (ds.num_of_work > 0) {
+        if (descent_walk(&ds, ds.work[--ds.num_of_work])) {
+            goto done;
+        }
+    }
+    qsort(ds.cmds, ds.num_of_cmds, sizeof(command_data), descent_cmd_cmp);
+    err = 0;
+
+    done:
+    if (ds.visited != NULL) {
+        for (size_t i = 0; i < (*image).num_of_segments; i++) {
+            free(ds.visited[i]);
+        }
+    }
+    free(ds.visited);
+    free(ds.work);
+    if (err) {
+        free(ds.cmds);
+        ds.cmds = NULL;
+        ds.num_of_cmds = 0;
+    }
+    *cmds = ds.cmds;
+    *num_of_cmds = ds.num_of_cmds;
+    return err;
+}
+
+// LIST ONLY THE COMMANDS disasm_collect_reachable() FINDS
+uint32_t disasm_recursive(out_sink *out, const hex_image *image, uint64_t entry, uint8_t pc,
+    uint8_t check_decoder, uint8_t *err) {
+    command_data *cmds;
+    size_t num_of_cmds;
+    uint32_t mismatches = 0;
+
+    if ((*err = disasm_collect_reachable(image, entry, pc, &cmds, &num_of_cmds)) != 0) {
+        return 0;
+    }
+    for (size_t i = 0; i < num_of_cmds; i++) {
+        if (check_decoder) {
+            mismatches += decoder_mismatch(out, &cmds[i]);
+        }
+        print_decoded(out, &cmds[i], NULL);
+    }
+    free(cmds);
+    return mismatches;
+}
+
+//================================================================
+//===================== Control Flow Graph =======================
+//================================================================
+
+static const char *cfg_edge_name[] = { "fallthrough", "taken", "jump", "call" };
+
+static uint8_t cfg_length(const command_data *cd) {
+    return (((*cd).byte_data & 0b11) == 0b11) ? 4 : 2;
+}
+
+// 1 FOR EVERY COMMAND THAT ENDS A BASIC BLOCK
+static uint8_t cfg_is_transfer(uint16_t opcode) {
+    switch (opcode) {
+    case op_beq:
+    case op_bne:
+    case op_blt:
+    case op_bge:
+    case op_bltu:
+    case op_bgeu:
+    case op_jal:
+    case op_jalr:
+    case op_c_beqz:
+    case op_c_bnez:
+    case op_c_j:
+    case op_c_jal:
+    case op_c_jr:
+    case op_c_jalr:
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+// INDEX OF THE COMMAND AT address OR num_of_cmds
+static size_t cfg_find_command(const command_data *cmds, size_t num_of_cmds, uint64_t address) {
+    size_t lo = 0;
+    size_t hi = num_of_cmds;
+
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (cmds[mid].offset < address) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return (lo < num_of_cmds && cmds[lo].offset == address) ? lo : num_of_cmds;
+}
+
+// BLOCK HOLDING COMMAND cmd
+static uint32_t cfg_find_block(const cfg_graph *cfg, size_t cmd) {
+    size_t lo = 0;
+    size_t hi = (*cfg).num_of_blocks;
+
+    while (hi - lo > 1) {
+        size_t mid = lo + (hi - lo) / 2;
+        if ((*cfg).first[mid] <= cmd) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+static void cfg_add_edge(cfg_graph *cfg, uint32_t to, uint8_t kind) {
+    (*cfg).succ[(*cfg).num_of_edges] = to;
+    (*cfg).kind[(*cfg).num_of_edges] = kind;
+    (*cfg).num_of_edges++;
+}
+
+// SPLIT cmds, SORTED BY ADDRESS, INTO BASIC BLOCKS AND LINK THEM
+// A BLOCK STARTS AT THE FIRST COMMAND, A DIRECT TARGET, AFTER A TRANSFER OR AFTER A GAP
+// TARGETS OUTSIDE cmds AND INDIRECT JUMPS GET NO EDGE
+uint8_t cfg_build(cfg_graph *cfg, const command_data *cmds, size_t num_of_cmds) {
+    uint8_t *leader = calloc(num_of_cmds + 1, 1);
+
+    memset(cfg, 0, sizeof(*cfg));
+    if (leader == NULL || num_of_cmds > UINT32_MAX) {
+        goto error;
+    }
+    for (size_t i = 0; i < num_of_cmds; i++) {
+        const command_data *cd = &cmds[i];
+        if (i == 0 || cmds[i - 1].offset + cfg_length(&cmds[i - 1]) != (*cd).offset) {
+            leader[i] = 1;
+        }
+        if (!cfg_is_transfer((*cd).opcode)) {
+            continue;
+        }
+        leader[i + 1] = 1;
+        if ((*cd).opcode != op_jalr && (*cd).opcode != op_c_jr && (*cd).opcode != op_c_jalr) {
+            size_t target = cfg_find_command(cmds, num_of_cmds, (*cd).offset + (*cd).imm);
+            leader[target] = 1;
+        }
+    }
+    for (size_t i = 0; i < num_of_cmds; i++) {
+        (*cfg).num_of_blocks += leader[i];
+    }
+
+    // AT MOST TWO EDGES LEAVE A BLOCK
+    (*cfg).first = malloc(((*cfg).num_of_blocks + 1) * sizeof(uint32_t));
+    (*cfg).edge_index = malloc(((*cfg).num_of_blocks + 1) * sizeof(uint32_t));
+    (*cfg).succ = malloc((2 * (*cfg).num_of_blocks + 1) * sizeof(uint32_t));
+    (*cfg).kind = malloc(2 * (*cfg).num_of_blocks + 1);
+    if ((*cfg).first == NULL || (*cfg).edge_index == NULL || (*cfg).succ == NULL || (*cfg).kind == NULL) {
+        goto error;
+    }
+    uint32_t block = 0;
+    for (size_t i = 0; i < num_of_cmds; i++) {
+        if (leader[i]) {
+            (*cfg).first[block++] = i;
+        }
+    }
+    (*cfg).first[block] = num_of_cmds;
+
+    for (block = 0; block < (*cfg).num_of_blocks; block++) {
+        const command_data *last = &cmds[(*cfg).first[block + 1] - 1];
+        uint8_t falls = (*cfg).first[block + 1] < num_of_cmds &&
+            (*last).offset + cfg_length(last) == cmds[(*cfg).first[block + 1]].offset;
+        size_t target = num_of_cmds;
+        uint8_t kind = cfg_edge_taken;
+
+        (*cfg).edge_index[block] = (*cfg).num_of_edges;
+        switch ((*last).opcode) {
+        case op_jal:
+        case op_c_jal:
+        case op_c_j:
+            target = cfg_find_command(cmds, num_of_cmds, (*last).offset + (*last).imm);
+            if ((*last).opcode == op_c_j || (*last).rd == rv_reg_zero) {
+                kind = cfg_edge_jump;
+                falls = 0;
+            } else {
+                kind = cfg_edge_call;
+            }
+            break;
+        case op_beq:
+        case op_bne:
+        case op_blt:
+        case op_bge:
+        case op_bltu:
+        case op_bgeu:
+        case op_c_beqz:
+        case op_c_bnez:
+            target = cfg_find_command(cmds, num_of_cmds, (*last).offset + (*last).imm);
+            break;
+        case op_jalr:
+            falls &= (*last).rd != rv_reg_zero;
+            break;
+        case op_c_jr:
+            falls = 0;
+            break;
+        default:
+            break;
+        }
+        if (target < num_of_cmds) {
+            cfg_add_edge(cfg, cfg_find_block(cfg, target), kind);
+        }
+        if (falls) {
+            cfg_add_edge(cfg, block + 1, cfg_edge_fallthrough);
+        }
+    }
+    (*cfg).edge_index[(*cfg).num_of_blocks] = (*cfg).num_of_edges;
+    free(leader);
+    return 0;
+
+    error:
+    free(leader);
+    cfg_free(cfg);
+    return 1;
+}
+
+void cfg_free(cfg_graph *cfg) {
+    free((*cfg).first);
+    free((*cfg).edge_index);
+    free((*cfg).succ);
+    free((*cfg).kind);
+    memset(cfg, 0, sizeof(*cfg));
+}
+
+// BLOCK NODES "b<N>" LABELED WITH THEIR ADDRESS RANGE, EDGES LABELED WITH THEIR KIND
+void cfg_write_dot(out_sink *out, const cfg_graph *cfg, const command_data *cmds) {
+    out_puts(out, "digraph cfg {\n    node [shape=box, fontname=monospace];\n");
+    for (uint32_t b = 0; b < (*cfg).num_of_blocks; b++) {
+        const command_data *last = &cmds[(*cfg).first[b + 1] - 1];
+        out_puts(out, "    b");
+        out_dec(out, b);
+        out_puts(out, " [label=\"");
+        out_hex(out, cmds[(*cfg).first[b]].offset, 8);
+        out_puts(out, " - ");
+        out_hex(out, (*last).offset + cfg_length(last), 8);
+        out_puts(out, "\\n");
+        out_dec(out, (*cfg).first[b + 1] - (*cfg).first[b]);
+        out_puts(out, " commands\"];\n");
+    }
+    for (uint32_t b = 0; b < (*cfg).num_of_blocks; b++) {
+        for (uint32_t e = (*cfg).edge_index[b]; e < (*cfg).edge_index[b + 1]; e++) {
+            out_puts(out, "    b");
+            out_dec(out, b);
+            out_puts(out, " -> b");
+            out_dec(out, (*cfg).succ[e]);
+            out_puts(out, " [label=\"");
+            out_puts(out, cfg_edge_name[(*cfg).kind[e]]);
+            out_puts(out, "\"];\n");
+        }
+    }
+    out_puts(out, "}\n");
+}
+
+// {"blocks": [{"id", "start", "end", "commands"}], "edges": [{"from", "to", "kind"}]}
+void cfg_write_json(out_sink *out, const cfg_graph *cfg, const command_data *cmds) {
+    out_puts(out, "{\n  \"blocks\": [");
+    for (uint32_t b = 0; b < (*cfg).num_of_blocks; b++) {
+        const command_data *last = &cmds[(*cfg).first[b + 1] - 1];
+        out_puts(out, (b == 0) ? "\n    {\"id\": " : ",\n    {\"id\": ");
+        out_dec(out, b);
+        out_puts(out, ", \"start\": \"");
+        out_hex(out, cmds[(*cfg).first[b]].offset, 8);
+        out_puts(out, "\", \"end\": \"");
+        out_hex(out, (*last).offset + cfg_length(last), 8);
+        out_puts(out, "\", \"commands\": ");
+        out_dec(out, (*cfg).first[b + 1] - (*cfg).first[b]);
+        out_puts(out, "}");
+    }
+    out_puts(out, "\n  ],\n  \"edges\": [");
+    for (uint32_t b = 0; b < (*cfg).num_of_blocks; b++) {
+        for (uint32_t e = (*cfg).edge_index[b]; e < (*cfg).edge_index[b + 1]; e++) {
+            out_puts(out, (e == 0) ? "\n    {\"from\": " : ",\n    {\"from\": ");
+            out_dec(out, b);
+            out_puts(out, ", \"to\": ");
+            out_dec(out, (*cfg).succ[e]);
+            out_puts(out, ", \"kind\": \"");
+            out_puts(out, cfg_edge_name[(*cfg).kind[e]]);
+            out_puts(out, "\"}");
+        }
+    }
+    out_puts(out, "\n  ]\n}\n");
+}
+
+//================================================================
+//===================== Annotated Listing ========================
+//================================================================
+
+// JUMP AND BRANCH TARGETS OF A LISTING, LABELLED ONCE ALL COMMAND OFFSETS PASSED label_keep()
+typedef struct {
+    label_set set;
+    // ALL EVEN TARGETS, SORTED BEFORE THE FIRST label_keep(), THEN THE KEPT ONES IN FRONT
+    uint64_t *target;
+    size_t num_of_targets;
+    size_t capacity;
+    size_t num_of_labels;
+    size_t next;
+} label_index;
+
+static void label_index_init(label_index *index) {
+    memset(index, 0, sizeof(*index));
+}
+
+static void label_index_free(label_index *index) {
+    label_set_free(&(*index).set);
+    free((*index).target);
+    label_index_init(index);
+}
+
+static uint8_t label_index_add(label_index *index, const command_data *cd) {
+    uint64_t target = (*cd).offset + (*cd).imm;
+
+    if (target & 1) {
+        return 0;
+    }
+    if ((*index).num_of_targets == (*index).capacity) {
+        size_t capacity = (*index).capacity ? 2 * (*index).capacity : 1024;
+        uint64_t *grown = realloc((*index).target, capacity * sizeof(uint64_t));
+        if (grown == NULL) {
+            return 1;
+        }
+        (*index).target = grown;
+        (*index).capacity = capacity;
+    }
+    (*index).target[(*index).num_of_targets++] = target;
+    return 0;
+}
+
+static int label_cmp(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+
+    return (x > y) - (x < y);
+}
+
+// HASH AND SORT THE TARGETS ADDED
+static uint8_t label_index_seal(label_index *index) {
+    if (label_set_init(&(*index).set, (*index).num_of_targets)) {
+        return 1;
+    }
+    for (size_t i = 0; i < (*index).num_of_targets; i++) {
+        label_set_add(&(*index).set, (*index).target[i]);
+    }
+    qsort((*index).target, (*index).num_of_targets, sizeof(uint64_t), label_cmp);
+    return 0;
+}
+
+// CALLED WITH EVERY LISTED COMMAND OFFSET IN ASCENDING ORDER, KEEPS THE TARGETS AMONG THEM
+static void label_keep(label_index *index, uint64_t offset) {
+    size_t t = (*index).next;
+
+    while (t < (*index).num_of_targets && (*index).target[t] < offset) {
+        t++;
+    }
+    if (t < (*index).num_of_targets && (*index).target[t] == offset) {
+        label_set_confirm(&(*index).set, offset);
+        (*index).target[(*index).num_of_labels++] = offset;
+        while (t < (*index).num_of_targets && (*index).target[t] == offset) {
+            t++;
+        }
+    }
+    (*index).next = t;
+}
+
+// "<symbol>:" LINE IF A SYMBOL STARTS AT offset, "L_xxxx:" LINE IF offset IS THE NEXT LABEL
+// CALLED WITH OFFSETS IN ASCENDING ORDER
+static void note_lines(out_sink *out, label_index *index, listing_notes *notes, uint64_t offset) {
+    symbol_table *symbols = (*notes).symbols;
+
+    if (symbols != NULL) {
+        const symbol *sym = symbol_at(symbols, offset);
+        if (sym != NULL && (*sym).start == offset) {
+            pseudo_flush(out, notes);
+            if (out_reserve(out, (*symbols).longest_name + 4)) {
+                return;
+            }
+            char *tmp_ptr = (*out).buf + (*out).len;
+            *tmp_ptr++ = '<';
+            tmp_ptr = symbol_name(tmp_ptr, symbols, sym, offset);
+            *tmp_ptr++ = '>';
+            *tmp_ptr++ = ':';
+            *tmp_ptr++ = '\n';
+            (*out).len = tmp_ptr - (*out).buf;
+        }
+    }
+    if ((*index).next < (*index).num_of_labels && (*index).target[(*index).next] == offset) {
+        pseudo_flush(out, notes);
+        if (out_reserve(out, 24)) {
+            return;
+        }
+        char *tmp_ptr = label_name((*out).buf + (*out).len, offset);
+        *tmp_ptr++ = ':';
+        *tmp_ptr++ = '\n';
+        (*out).len = tmp_ptr - (*out).buf;
+        (*index).next++;
+    }
+}
+
+// 1 IF data MAY BE A JUMP OR BRANCH, CHEAPER THAN bp_opcode_table()
+static uint8_t label_may_target(uint32_t data) {
+    if ((data & 0b11) == 0b11) {
+        return (data & 0x7f) == 0x63 || (data & 0x7f) == 0x6f;
+    }
+    // c.jal, c.j, c.beqz, c.bnez
+    return (data & 0b11) == 0b01 && ((data >> 13) == 0b001 || (data >> 13) >= 0b101);
+}
+
+// FIRST WALK OF disasm_annotated(), TARGETS OF THE COMMANDS IN [start, end) OF segment THAT ARE LISTED
+static uint8_t label_index_walk(label_index *index, const hex_segment *segment, size_t start, size_t end,
+    uint8_t pc) {
+    code_span span;
+    command_data cd;
+    uint8_t *listed;
+    const rv_decode_table *table = &decode_tables[pc];
+
+    // ONE BIT PER HALFWORD OF THE SEGMENT
+    if ((listed = calloc((*segment).size / 16 + 1, 1)) == NULL) {
+        goto error;
+    }
+    span.data = (*segment).data;
+    span.size = (*segment).size;
+    span.base = (*segment).base;
+    span.pos = start;
+    span.destruct_flag = 0;
+    cd.pc = pc;
+    while (span.pos < end) {
+        size_t pos = span.pos;
+        if (end != (size_t)-1) {
+            span.destruct_flag = 0;
+        }
+        if ((cd.byte_data = get_next_command(&span)) == 0) {
+            break;
+        }
+        listed[pos >> 4] |= 1 << ((pos >> 1) & 7);
+        if (label_may_target(cd.byte_data)) {
+            cd.opcode = decode_op(table, cd.byte_data);
+            if (label_is_target(cd.opcode)) {
+                cd.offset = span.base + pos;
+                opcode_data[cd.opcode].parse_func(&cd);
+                if (label_index_add(index, &cd)) {
+                    goto error;
+                }
+            }
+        }
+    }
+    if (label_index_seal(index)) {
+        goto error;
+    }
+    for (size_t t = 0; t < (*index).num_of_targets; t++) {
+        uint64_t pos = (*index).target[t] - span.base;
+        if ((*index).target[t] >= span.base && pos < span.size && (listed[pos >> 4] & (1 << ((pos >> 1) & 7)))) {
+            label_keep(index, (*index).target[t]);
+        }
+    }
+    (*index).next = 0;
+    free(listed);
+    return 0;
+
+    error:
+    free(listed);
+    return 1;
+}
+
+// disasm_range() OR disasm_serial() IF end IS (size_t)-1 WITH
+// DISASM_LABELS - AN "L_xxxx:" LINE BEFORE EVERY LISTED JUMP OR BRANCH TARGET AND THOSE TARGETS PRINTED AS
+//                 LABELS, AN EXTRA WALK OVER THE SEGMENT FINDS THEM
+// DISASM_PSEUDO - PSEUDO-INSTRUCTIONS, auipc WITH THE addi OR jalr AFTER IT AS ONE la, call OR tail
+// symbols - A "<symbol>:" LINE WHERE A SYMBOL STARTS, "<symbol+0x1c>" AFTER EVERY OFFSET INSIDE ONE
+//           AND CALL TARGETS BY NAME, MAY BE NULL
+uint32_t disasm_annotated(out_sink *out, const hex_segment *segment, size_t start, size_t end, uint8_t pc,
+    uint8_t check_decoder, uint8_t flags, symbol_table *symbols, uint8_t *err) {
+    label_index index;
+    listing_notes notes;
+    code_span span;
+    command_data cd;
+    uint32_t mismatches = 0;
+    const rv_decode_table *table = &decode_tables[pc];
+
+    label_index_init(&index);
+    if ((flags & DISASM_LABELS) && label_index_walk(&index, segment, start, end, pc)) {
+        label_index_free(&index);
+        *err = 1;
+        return 0;
+    }
+    notes.labels = (flags & DISASM_LABELS) ? &index.set : NULL;
+    notes.symbols = symbols;
+    notes.pseudo = (flags & DISASM_PSEUDO) != 0;
+    notes.has_held = 0;
+
+    span.data = (*segment).data;
+    span.size = (*segment).size;
+    span.base = (*segment).base;
+    span.pos = start;
+    span.destruct_flag = 0;
+    span.segment_end = 0;
+    cd.pc = pc;
+    while (span.pos < end) {
+        cd.offset = span.base + span.pos;
+        if (end != (size_t)-1) {
+            span.destruct_flag = 0;
+        }
+        if ((cd.byte_data = get_next_command(&span)) == 0) {
+            break;
+        }
+        if (span.segment_end) {
+            pseudo_flush(out, &notes);
+            out_puts(out, "================END OF SEGMENT================\n");
+            span.segment_end = 0;
+        }
+        note_lines(out, &index, &notes, cd.offset);
+        decode_command(table, &cd);
+        if (check_decoder) {
+            mismatches += decoder_mismatch(out, &cd);
+        }
+        print_noted(out, &cd, &notes);
+    }
+    pseudo_flush(out, &notes);
+    label_index_free(&index);
+    *err = 0;
+    return mismatches;
+}
+
+// disasm_print() WITH THE NOTES OF disasm_annotated(), cmds SORTED BY OFFSET
+uint32_t disasm_print_annotated(out_sink *out, const command_data *cmds, size_t num_of_cmds, uint8_t check_decoder,
+    uint8_t flags, symbol_table *symbols, uint8_t *err) {
+    label_index index;
+    listing_notes notes;
+    uint32_t mismatches = 0;
+
+    label_index_init(&index);
+    if (flags & DISASM_LABELS) {
+        for (size_t i = 0; i < num_of_cmds; i++) {
+            if (label_is_target(cmds[i].opcode) && label_index_add(&index, &cmds[i])) {
+                goto error;
+            }
+        }
+        if (label_index_seal(&index)) {
+            goto error;
+        }
+        for (size_t i = 0; i < num_of_cmds && index.next < index.num_of_targets; i++) {
+            label_keep(&index, cmds[i].offset);
+        }
+        index.next = 0;
+    }
+    notes.labels = (flags & DISASM_LABELS) ? &index.set : NULL;
+    notes.symbols = symbols;
+    notes.pseudo = (flags & DISASM_PSEUDO) != 0;
+    notes.has_held = 0;
+
+    for (size_t i = 0; i < num_of_cmds; i++) {
+        note_lines(out, &index, &notes, cmds[i].offset);
+        if (check_decoder) {
+            mismatches += decoder_mismatch(out, &cmds[i]);
+        }
+        print_noted(out, &cmds[i], &notes);
+    }
+    pseudo_flush(out, &notes);
+    label_index_free(&index);
+    *err = 0;
+    return mismatches;
+
+    error:
+    label_index_free(&index);
+    *err = 1;
+    return 0;
+}
+
+//================================================================
+//======================== Stream Input ==========================
+//================================================================
+
+#define STREAM_CHUNK    (1 << 16)
+
+// CODE RECEIVED BUT NOT DECODED YET, AT MOST ONE CUT COMMAND AFTER stream_decode()
+typedef struct {
+    out_sink *out;
+    uint8_t pc;
+    uint8_t check_decoder;
+    uint8_t *code;
+    size_t len;
+    size_t capacity;
+    uint64_t base;
+    uint8_t destruct_flag;
+    // END MARKER DECODED / END RECORD READ
+    uint8_t stopped;
+    uint8_t input_end;
+    uint8_t started;
+    uint64_t start;
+    uint8_t has_start;
+    hex_address address;
+    uint32_t mismatches;
+} stream_state;
+
+// DECODE EVERY WHOLE COMMAND OF THE PENDING CODE, KEEP THE CUT ONE FOR THE NEXT CHUNK
+static void stream_decode(stream_state *st) {
+    code_span span;
+    command_data cd;
+    const rv_decode_table *table = &decode_tables[(*st).pc];
+
+    span.data = (*st).code;
+    span.size = (*st).len;
+    span.base = (*st).base;
+    span.pos = 0;
+    span.destruct_flag = (*st).destruct_flag;
+    span.segment_end = 0;
+    cd.pc = (*st).pc;
+    while (!(*st).stopped) {
+        size_t left = span.size - span.pos;
+        if (left < 2 || ((span.data[span.pos] & 0b11) == 0b11 && left < 4)) {
+            break;
+        }
+        cd.offset = span.base + span.pos;
+        if ((cd.byte_data = get_next_command(&span)) == 0) {
+            (*st).stopped = 1;
+            break;
+        }
+        (*st).mismatches += disasm_command((*st).out, &span, &cd, table, (*st).check_decoder);
+    }
+    memmove((*st).code, (*st).code + span.pos, span.size - span.pos);
+    (*st).len -= span.pos;
+    (*st).base += span.pos;
+    (*st).destruct_flag = span.destruct_flag;
+}
+
+// QUEUE len BYTES LOADED AT address, A GAP DROPS THE CUT COMMAND BEFORE IT
+static uint8_t stream_push(stream_state *st, uint64_t address, const uint8_t *data, size_t len) {
+    if ((*st).has_start && address < (*st).start) {
+        if (address + len <= (*st).start) {
+            return 0;
+        }
+        data += (*st).start - address;
+        len -= (*st).start - address;
+        address = (*st).start;
+    }
+    if (address != (*st).base + (*st).len || !(*st).started) {
+        stream_decode(st);
+        // LIKE THE FILE LISTING, CODE FROM THE START ADDRESS ENDS WITH ITS SEGMENT
+        if ((*st).started && (*st).has_start) {
+            (*st).stopped = 1;
+            return 0;
+        }
+        (*st).started = 1;
+        (*st).len = 0;
+        (*st).base = address;
+        (*st).destruct_flag = 0;
+    }
+    if ((*st).len + len > (*st).capacity) {
+        size_t capacity = (*st).capacity ? 2 * (*st).capacity : STREAM_CHUNK;
+        while (capacity < (*st).len + len) {
+            capacity *= 2;
+        }
+        uint8_t *grown = realloc((*st).code, capacity);
+        if (grown == NULL) {
+            return 1;
+        }
+        (*st).code = grown;
+        (*st).capacity = capacity;
     }
+    memcpy((*st).code + (*st).len, data, len);
+    (*st).len += len;
+    return 0;
 }
 
-//================================================================
-//====================== Register Names ==========================
-//================================================================
-
-static const char rv_ireg_name_sym[32][5] = {
-    "zero", "ra",   "sp",   "gp",   "tp",   "t0",   "t1",   "t2",
-    "s0",   "s1",   "a0",   "a1",   "a2",   "a3",   "a4",   "a5",
-    "a6",   "a7",   "s2",   "s3",   "s4",   "s5",   "s6",   "s7",
-    "s8",   "s9",   "s10",  "s11",  "t3",   "t4",   "t5",   "t6",
-};
+// read(2) UP TO size BYTES, 0 AT END OF INPUT
+static ssize_t stream_read(int fd, uint8_t *buf, size_t size) {
+    ssize_t done;
 
-static const char rv_freg_name_sym[32][5] = {
-    "ft0",  "ft1",  "ft2",  "ft3",  "ft4",  "ft5",  "ft6",  "ft7",
-    "fs0",  "fs1",  "fa0",  "fa1",  "fa2",  "fa3",  "fa4",  "fa5",
-    "fa6",  "fa7",  "fs2",  "fs3",  "fs4",  "fs5",  "fs6",  "fs7",
-    "fs8",  "fs9",  "fs10", "fs11", "ft8",  "ft9",  "ft10", "ft11",
-};
+    do {
+        done = read(fd, buf, size);
+    } while (done < 0 && errno == EINTR);
+    return done;
+}
 
-static void print_decoded(command_data *cd)
-{
-    char tmp[80] = {0};
-    char *tmp_ptr = tmp;
-    const char *read_ptr;
-    const char *fmt;
+// RECORDS OF THE WHOLE LINES IN text, RETURNS THE BYTES USED OR -1 ON A BAD RECORD
+static ssize_t stream_hex_records(stream_state *st, const uint8_t *text, size_t size, uint8_t last) {
+    hex_map map;
+    hex_string h_str;
+    const uint8_t *eol = text + size;
 
-    fmt = opcode_data[(*cd).opcode].format;
-    while (*fmt) {
-        switch (*fmt) {
-        case 'O':
-            read_ptr = opcode_data[(*cd).opcode].name;
-            while (*read_ptr)
-            {
-                *tmp_ptr = *read_ptr;
-                tmp_ptr++;
-                read_ptr++;
-            }            
-            break;
-        case '(':
-            *tmp_ptr = '(';
-            tmp_ptr++;
-            break;
-        case ',':
-            *tmp_ptr = ',';
-            tmp_ptr++;
-            break;
-        case ')':
-            *tmp_ptr = ')';
-            tmp_ptr++;
-            break;
-        case '0':
-            read_ptr = rv_ireg_name_sym[(*cd).rd];
-            while (*read_ptr)
-            {
-                *tmp_ptr = *read_ptr;
-                tmp_ptr++;
-                read_ptr++;
-            }            
-            break;
-        case '1':
-            read_ptr = rv_ireg_name_sym[(*cd).rs1];
-            while (*read_ptr)
-            {
-                *tmp_ptr = *read_ptr;
-                tmp_ptr++;
-                read_ptr++;
-            }            
-            break;
-        case '2':
-            read_ptr = rv_ireg_name_sym[(*cd).rs2];
-            while (*read_ptr)
-            {
-                *tmp_ptr = *read_ptr;
-                tmp_ptr++;
-                read_ptr++;
-            }            
-            break;
-        case '3':
-            read_ptr = rv_ireg_name_sym[(*cd).rd];
-            while (*read_ptr)
-            {
-                *tmp_ptr = *read_ptr;
-                tmp_ptr++;
-                read_ptr++;
-            }            
-            break;
-        case '4':
-            read_ptr = rv_freg_name_sym[(*cd).rs1];
-            while (*read_ptr)
-            {
-                *tmp_ptr = *read_ptr;
-                tmp_ptr++;
-                read_ptr++;
-            }            
-            break;
-        case '5':
-            read_ptr = rv_freg_name_sym[(*cd).rs2];
-            while (*read_ptr)
-            {
-                *tmp_ptr = *read_ptr;
-                tmp_ptr++;
-                read_ptr++;
-            }            
-            break;
-        case '6':
-            read_ptr = rv_freg_name_sym[(*cd).rs3];
-            while (*read_ptr)
-            {
-                *tmp_ptr = *read_ptr;
-                tmp_ptr++;
-                read_ptr++;
-            }            
-            break;
-        case '7':
-            snprintf(tmp_ptr, 16, "%d", (*cd).rs1);
-            while (*tmp_ptr)
-            {
-                tmp_ptr++;
-            }            
-            break;
-        case 'i':
-            snprintf(tmp_ptr, 16, "%d", (*cd).imm);
-            while (*tmp_ptr)
-            {
-                tmp_ptr++;
-            }
-            break;
-        case 'o':
-            snprintf(tmp_ptr, 16, "0x%lx", (*cd).imm + (*cd).offset);
-            while (*tmp_ptr)
-            {
-                tmp_ptr++;
+    if (!last) {
+        while (eol > text && eol[-1] != 0x0a) {
+            eol--;
+        }
+    }
+    map.data = text;
+    map.size = eol - text;
+    map.pos = 0;
+    while (!hex_map_eof(&map) && !(*st).stopped) {
+        // SKIP BLANK LINES BETWEEN RECORDS
+        if (map.data[map.pos] == 0x0d || map.data[map.pos] == 0x0a) {
+            map.pos++;
+            continue;
+        }
+        if (read_next_str(&h_str, &map)) {
+            return -1;
+        }
+        switch (h_str.flags) {
+        case 0x00:
+            if (stream_push(st, (*st).address.upper + h_str.offset, h_str.data, h_str.length)) {
+                return -1;
             }
             break;
-        case 'c': {
-            read_ptr = csr_name((*cd).imm & 0xfff);
-            if (read_ptr) {
-                while (read_ptr)
-                {
-                    *tmp_ptr = *read_ptr;
-                    tmp_ptr++;
-                    read_ptr++;
-                }
-                
-            } else {
-                snprintf(tmp_ptr, 6, "0x%03x", (*cd).imm & 0xfff);
-                while (*tmp_ptr)
-                {
-                    tmp_ptr++;
-                }
+        case 0x01:
+            (*st).input_end = 1;
+            return map.pos;
+        default:
+            hex_address_update(&(*st).address, &h_str);
+            // START ADDRESS IS ONLY USED IF NO CODE CAME BEFORE IT
+            if ((*st).address.has_start && (*st).len == 0 && !(*st).has_start) {
+                (*st).start = (*st).address.start;
+                (*st).has_start = 1;
             }
             break;
         }
-        case 'r':
-            switch ((*cd).rm) {
-            case rv_rm_rne:
-                read_ptr = "rne";
-                while (*read_ptr)
-                {
-                    *tmp_ptr = *read_ptr;
-                    tmp_ptr++;
-                    read_ptr++;
-                }            
-                break;
-            case rv_rm_rtz:
-                read_ptr = "rtz";
-                while (*read_ptr)
-                {
-                    *tmp_ptr = *read_ptr;
-                    tmp_ptr++;
-                    read_ptr++;
-                }            
-                break;
-            case rv_rm_rdn:
-                read_ptr = "rdn";
-                while (*read_ptr)
-                {
-                    *tmp_ptr = *read_ptr;
-                    tmp_ptr++;
-                    read_ptr++;
-                }            
-                break;
-            case rv_rm_rup:
-                read_ptr = "rup";
-                while (*read_ptr)
-                {
-                    *tmp_ptr = *read_ptr;
-                    tmp_ptr++;
-                    read_ptr++;
-                }            
-                break;
-            case rv_rm_rmm:
-                read_ptr = "rmm";
-                while (*read_ptr)
-                {
-                    *tmp_ptr = *read_ptr;
-                    tmp_ptr++;
-                    read_ptr++;
-                }            
-                break;
-            case rv_rm_dyn:
-                read_ptr = "dyn";
-                while (*read_ptr)
-                {
-                    *tmp_ptr = *read_ptr;
-                    tmp_ptr++;
-                    read_ptr++;
-                }            
-                break;
-            default:
-                read_ptr = "inv";
-                while (*read_ptr)
-                {
-                    *tmp_ptr = *read_ptr;
-                    tmp_ptr++;
-                    read_ptr++;
-                }            
-                break;
-            }
-            break;
-        case 'p':
-            if ((*cd).pred & rv_fence_i) {
-                *tmp_ptr = 'i';
-                tmp_ptr++;
+    }
+    return map.pos;
+}
+
+// DECODE INTEL HEX (raw == 0) OR FLAT BINARY LOADED AT base FROM fd AS IT ARRIVES
+// NEVER SEEKS, SO fd MAY BE A PIPE; STOPS AT THE END MARKER, END RECORD OR END OF INPUT
+uint8_t disasm_stream(out_sink *out, int fd, uint8_t raw, uint64_t base, uint8_t pc, uint8_t check_decoder,
+    uint32_t *mismatches) {
+    stream_state st;
+    uint8_t *text = NULL;
+    size_t text_len = 0;
+    ssize_t done;
+
+    memset(&st, 0, sizeof(st));
+    st.out = out;
+    st.pc = pc;
+    st.check_decoder = check_decoder;
+    st.base = base;
+    if (!raw && (text = malloc(STREAM_CHUNK)) == NULL) {
+        goto error;
+    }
+    while (!st.stopped) {
+        if (raw) {
+            if (st.capacity < st.len + STREAM_CHUNK) {
+                uint8_t *grown = realloc(st.code, st.len + STREAM_CHUNK);
+                if (grown == NULL) {
+                    goto error;
+                }
+                st.code = grown;
+                st.capacity = st.len + STREAM_CHUNK;
             }
-            if ((*cd).pred & rv_fence_o) {
-                *tmp_ptr = 'o';
-                tmp_ptr++;
+            if ((done = stream_read(fd, st.code + st.len, STREAM_CHUNK)) < 0) {
+                goto error;
             }
-            if ((*cd).pred & rv_fence_r) {
-                *tmp_ptr = 'r';
-                tmp_ptr++;
+            st.len += done;
+        } else {
+            if ((done = stream_read(fd, text + text_len, STREAM_CHUNK - text_len)) < 0) {
+                goto error;
             }
-            if ((*cd).pred & rv_fence_w) {
-                *tmp_ptr = 'W';
-                tmp_ptr++;
+            text_len += done;
+            ssize_t used = stream_hex_records(&st, text, text_len, done == 0);
+            if (used < 0 || (used == 0 && text_len == STREAM_CHUNK)) {
+                goto error;
             }
+            memmove(text, text + used, text_len - used);
+            text_len -= used;
+        }
+        stream_decode(&st);
+        if (out_flush(out)) {
+            goto error;
+        }
+        if (done == 0 || st.input_end) {
             break;
-        case 's':
-            if ((*cd).succ & rv_fence_i) {
-                *tmp_ptr = 'i';
-                tmp_ptr++;
-            }
-            if ((*cd).succ & rv_fence_o) {
-                *tmp_ptr = 'o';
-                tmp_ptr++;
+        }
+    }
+    free(text);
+    free(st.code);
+    *mismatches = st.mismatches;
+    return 0;
+
+    error:
+    free(text);
+    free(st.code);
+    *mismatches = st.mismatches;
+    return 1;
+}
+
+//================================================================
+//================================================================
+//================================================================
+// MAP WHOLE .HEX FILE INTO MEMORY
+uint8_t hex_map_open(hex_map *map, const char *path) {
+    struct stat st;
+    int fd;
+
+    (*map).data = NULL;
+    (*map).size = 0;
+    (*map).pos = 0;
+    if ((fd = open(path, O_RDONLY)) < 0) {
+        goto error;
+    }
+    if (fstat(fd, &st) != 0) {
+        goto error_close;
+    }
+    if (st.st_size > 0) {
+        void *data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            goto error_close;
+        }
+        madvise(data, st.st_size, MADV_SEQUENTIAL);
+        (*map).data = data;
+        (*map).size = st.st_size;
+    }
+    close(fd);
+    return 0;
+
+    error_close:
+    close(fd);
+    error:
+    return 1;
+}
+
+void hex_map_close(hex_map *map) {
+    if ((*map).data != NULL) {
+        munmap((void *)(*map).data, (*map).size);
+    }
+    (*map).data = NULL;
+    (*map).size = 0;
+    (*map).pos = 0;
+}
+
+uint8_t hex_map_eof(const hex_map *map) {
+    return (*map).pos >= (*map).size;
+}
+
+//================================================================
+//===================== Hex Record Parser ========================
+//================================================================
+
+// EVERY RECORD PARSER MAY READ HEX_RECORD_READ CHARS FROM str, THE SIMD ONES TAKE AT MOST HEX_RECORD_SIMD DATA BYTES
+#define HEX_RECORD_READ 64
+#define HEX_RECORD_SIMD 16
+
+// CONVERT count BYTES (2 * count CHARS) INTO out, VERIFY CHARS AND CHECKSUM
+// RETURN 0 IF ALL CHARS ARE HEX DIGITS AND THE BYTES SUM TO 0 MOD 256
+typedef uint8_t (*hex_record_func)(const uint8_t *str, uint8_t *out, uint16_t count);
+
+static uint8_t hex_record_scalar(const uint8_t *str, uint8_t *out, uint16_t count) {
+    uint8_t invalid = 0;
+    uint8_t sum = 0;
+
+    for (uint16_t i = 0; i < count; i++) {
+        uint8_t hi = str_byte_to_hex(str[2 * i]);
+        uint8_t lo = str_byte_to_hex(str[2 * i + 1]);
+        invalid |= (hi | lo) & 0xf0;
+        out[i] = (hi << 4) | lo;
+        sum += out[i];
+    }
+    return (invalid != 0) || (sum != 0);
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+
+// FIRST n BYTES OF tail_mask + 32 - n ARE 0xff
+static const uint8_t tail_mask[64] = {
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+};
+
+// '0'-'9' -> 0-9, 'A'-'F'/'a'-'f' -> 10-15, INVALID CHARS SET BITS IN invalid
+__attribute__((target("sse2")))
+static __m128i hex_nibbles_sse2(__m128i c, __m128i keep, uint32_t *invalid) {
+    __m128i lower = _mm_or_si128(c, _mm_set1_epi8(0x20));
+    __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('0' - 1)),
+        _mm_cmpgt_epi8(_mm_set1_epi8('9' + 1), c));
+    __m128i alpha = _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)),
+        _mm_cmpgt_epi8(_mm_set1_epi8('f' + 1), lower));
+    __m128i nib = _mm_add_epi8(_mm_and_si128(c, _mm_set1_epi8(0x0f)), _mm_and_si128(alpha, _mm_set1_epi8(9)));
+
+    *invalid |= ~_mm_movemask_epi8(_mm_or_si128(digit, alpha)) & _mm_movemask_epi8(keep);
+    return _mm_and_si128(nib, keep);
+}
+
+__attribute__((target("sse2")))
+static uint8_t hex_record_sse2(const uint8_t *str, uint8_t *out, uint16_t count) {
+    const __m128i zero = _mm_setzero_si128();
+    __m128i sum = zero;
+    uint32_t invalid = 0;
+
+    for (uint16_t i = 0; i < count; i += 8) {
+        uint8_t chars = (count - i >= 8) ? 16 : 2 * (count - i);
+        __m128i keep = _mm_loadu_si128((const __m128i *)(tail_mask + 32 - chars));
+        __m128i nib = hex_nibbles_sse2(_mm_loadu_si128((const __m128i *)(str + 2 * i)), keep, &invalid);
+        // EVERY 16-BIT LANE HOLDS (lo << 8) | hi, MAKE IT (hi << 4) | lo
+        __m128i pair = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(nib, _mm_set1_epi16(0x00ff)), 4),
+            _mm_srli_epi16(nib, 8));
+        __m128i bytes = _mm_packus_epi16(pair, zero);
+        _mm_storel_epi64((__m128i *)(out + i), bytes);
+        sum = _mm_add_epi64(sum, _mm_sad_epu8(bytes, zero));
+    }
+    sum = _mm_add_epi64(sum, _mm_srli_si128(sum, 8));
+    return (invalid != 0) || ((_mm_cvtsi128_si32(sum) & 0xff) != 0);
+}
+
+__attribute__((target("avx2")))
+static uint8_t hex_record_avx2(const uint8_t *str, uint8_t *out, uint16_t count) {
+    __m128i sum = _mm_setzero_si128();
+    uint32_t invalid = 0;
+
+    for (uint16_t i = 0; i < count; i += 16) {
+        uint8_t chars = (count - i >= 16) ? 32 : 2 * (count - i);
+        __m256i keep = _mm256_loadu_si256((const __m256i *)(tail_mask + 32 - chars));
+        __m256i c = _mm256_loadu_si256((const __m256i *)(str + 2 * i));
+        __m256i lower = _mm256_or_si256(c, _mm256_set1_epi8(0x20));
+        __m256i digit = _mm256_and_si256(_mm256_cmpgt_epi8(c, _mm256_set1_epi8('0' - 1)),
+            _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), c));
+        __m256i alpha = _mm256_and_si256(_mm256_cmpgt_epi8(lower, _mm256_set1_epi8('a' - 1)),
+            _mm256_cmpgt_epi8(_mm256_set1_epi8('f' + 1), lower));
+        __m256i nib = _mm256_add_epi8(_mm256_and_si256(c, _mm256_set1_epi8(0x0f)),
+            _mm256_and_si256(alpha, _mm256_set1_epi8(9)));
+
+        invalid |= ~(uint32_t)_mm256_movemask_epi8(_mm256_or_si256(digit, alpha)) &
+            (uint32_t)_mm256_movemask_epi8(keep);
+        nib = _mm256_and_si256(nib, keep);
+        __m256i pair = _mm256_or_si256(_mm256_slli_epi16(_mm256_and_si256(nib, _mm256_set1_epi16(0x00ff)), 4),
+            _mm256_srli_epi16(nib, 8));
+        __m128i bytes = _mm_packus_epi16(_mm256_castsi256_si128(pair), _mm256_extracti128_si256(pair, 1));
+        _mm_storeu_si128((__m128i *)(out + i), bytes);
+        sum = _mm_add_epi64(sum, _mm_sad_epu8(bytes, _mm_setzero_si128()));
+    }
+    sum = _mm_add_epi64(sum, _mm_srli_si128(sum, 8));
+    return (invalid != 0) || ((_mm_cvtsi128_si32(sum) & 0xff) != 0);
+}
+#endif
+
+static hex_record_func hex_record = hex_record_scalar;
+
+// PICK THE WIDEST RECORD PARSER THE CPU SUPPORTS
+void hex_record_init(void) {
+    hex_record = hex_record_scalar;
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        hex_record = hex_record_avx2;
+    } else if (__builtin_cpu_supports("sse2")) {
+        hex_record = hex_record_sse2;
+    }
+#endif
+}
+
+// TRANSLATE .HEX FILE STRING BYTE(2 char) TO HEX FORMAT
+uint8_t str_byte_to_hex(uint8_t str_byte) {
+    if ((0x30 <= str_byte) && (str_byte <= 0x39)) {
+        return str_byte - 0x30;
+    } else if ((0x41 <= str_byte) && (str_byte <= 0x46)) {
+        return str_byte - 0x37;
+    } else if ((0x61 <= str_byte) && (str_byte <= 0x66)) {
+        return str_byte - 0x57;
+    }
+    return 0xff;
+}
+
+// NEXT 16 OR 32 BIT COMMAND OF THE SPAN, 0 AT THE END OF THE SPAN OR CODE
+uint32_t get_next_command(code_span *span) {
+    const uint8_t *ptr = (*span).data + (*span).pos;
+    size_t left = (*span).size - (*span).pos;
+    uint32_t data;
+
+    if (left < 2) {
+        goto error;
+    }
+    if ((ptr[0] & 0b11) != 0b11)
+    {
+        data = ptr[0] | (ptr[1] << 8);
+        (*span).pos += 2;
+    } else {
+        if (left < 4) {
+            goto error;
+        }
+        data = ptr[0] | (ptr[1] << 8) | (ptr[2] << 16) | ((uint32_t)ptr[3] << 24);
+        (*span).pos += 4;
+    }
+
+    switch (data)
+    {
+    case 0b01:
+        (*span).destruct_flag = 1;
+        break;
+    case 0b10:
+        if ((*span).destruct_flag == 1) {
+            goto error;
+        }
+        break;
+    case 0b00:
+        (*span).segment_end = 1;
+        data = 0b101; // MAKE NOP INSTEAD OF ERROR
+    default:
+        (*span).destruct_flag = 0;
+        break;
+    }
+        
+    return data;
+
+    error:
+    return 0;
+}
+
+uint8_t read_next_str(hex_string* h_str, hex_map *map) {
+    const uint8_t *str = (*map).data + (*map).pos;
+    size_t left = (*map).size - (*map).pos;
+    uint8_t pad[HEX_RECORD_READ];
+    uint8_t record[sizeof((*h_str).data) + 5];
+
+    // ':' LL AAAA TT <data> CC
+    if (left < 11 || ((*h_str).legit = str[0]) != ':') {
+        goto error;
+    }
+    uint8_t hi = str_byte_to_hex(str[1]);
+    uint8_t lo = str_byte_to_hex(str[2]);
+    uint8_t length = (hi << 4) | lo;
+    uint16_t count = length + 5;
+    if (((hi | lo) & 0xf0) || left < 1 + 2 * (size_t)count) {
+        goto error;
+    }
+    const uint8_t *src = str + 1;
+    if (length > HEX_RECORD_SIMD) {
+        // LONG RECORDS ARE RARE, THE SCALAR PARSER READS EXACTLY 2 * count CHARS
+        if (hex_record_scalar(src, record, count)) {
+            goto error;
+        }
+    } else {
+        // NEAR THE END OF THE MAP PARSE FROM A PADDED COPY
+        if (left - 1 < HEX_RECORD_READ) {
+            memset(pad, '0', sizeof(pad));
+            memcpy(pad, src, 2 * count);
+            src = pad;
+        }
+        if (hex_record(src, record, count)) {
+            goto error;
+        }
+    }
+    (*h_str).length = record[0];
+    (*h_str).offset = (record[1] << 8) | record[2];
+    (*h_str).flags = record[3];
+    memcpy((*h_str).data, record + 4, length);
+    (*h_str).checksum = record[4 + length];
+    (*h_str).cur_ptr = 0;
+    // IGNORE '\n'
+    const uint8_t *eol = memchr(str, 0x0a, left);
+    (*map).pos = (eol != NULL) ? (size_t)(eol - (*map).data) + 1 : (*map).size;
+    return 0;
+
+    error:
+    return 1;
+}
+
+//================================================================
+//======================== Hex Image =============================
+//================================================================
+
+// COPY len BYTES AT address INTO THE IMAGE, EXTEND THE LAST SEGMENT IF CONTIGUOUS
+// FOLD EXTENDED ADDRESS (02, 04) AND START ADDRESS (03, 05) RECORDS INTO address
+void hex_address_update(hex_address *address, const hex_string *h_str) {
+    const uint8_t *data = (*h_str).data;
+
+    switch ((*h_str).flags) {
+    case 0x02:
+        // EXTENDED SEGMENT ADDRESS, DATA AT SEGMENT * 16 + OFFSET
+        if ((*h_str).length == 2) {
+            (*address).upper = (uint64_t)((data[0] << 8) | data[1]) << 4;
+        }
+        break;
+    case 0x03:
+        // START SEGMENT ADDRESS CS:IP
+        if ((*h_str).length == 4) {
+            (*address).start = ((uint64_t)((data[0] << 8) | data[1]) << 4) + ((data[2] << 8) | data[3]);
+            (*address).has_start = (*address).start != 0;
+        }
+        break;
+    case 0x04:
+        // EXTENDED LINEAR ADDRESS, UPPER 16 BITS OF EVERY FOLLOWING OFFSET
+        if ((*h_str).length == 2) {
+            (*address).upper = (uint64_t)((data[0] << 8) | data[1]) << 16;
+        }
+        break;
+    case 0x05:
+        // START LINEAR ADDRESS EIP
+        if ((*h_str).length == 4) {
+            (*address).start = ((uint64_t)data[0] << 24) | (data[1] << 16) | (data[2] << 8) | data[3];
+            (*address).has_start = (*address).start != 0;
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+static uint8_t hex_image_append(hex_image *image, uint64_t address, const uint8_t *data, size_t len) {
+    hex_segment *segment = NULL;
+
+    if ((*image).num_of_segments > 0) {
+        segment = &(*image).segment[(*image).num_of_segments - 1];
+        if ((*segment).base + (*segment).size != address) {
+            segment = NULL;
+        }
+    }
+    if (segment == NULL) {
+        if ((*image).num_of_segments == (*image).capacity) {
+            size_t capacity = (*image).capacity ? 2 * (*image).capacity : 16;
+            hex_segment *grown = realloc((*image).segment, capacity * sizeof(hex_segment));
+            if (grown == NULL) {
+                goto error;
             }
-            if ((*cd).succ & rv_fence_r) {
-                *tmp_ptr = 'r';
-                tmp_ptr++;
+            (*image).segment = grown;
+            (*image).capacity = capacity;
+        }
+        segment = &(*image).segment[(*image).num_of_segments++];
+        (*segment).base = address;
+        (*segment).data = NULL;
+        (*segment).size = 0;
+        (*segment).capacity = 0;
+    }
+    if ((*segment).size + len > (*segment).capacity) {
+        size_t capacity = (*segment).capacity ? 2 * (*segment).capacity : 4096;
+        while (capacity < (*segment).size + len) {
+            capacity *= 2;
+        }
+        uint8_t *grown = realloc((*segment).data, capacity);
+        if (grown == NULL) {
+            goto error;
+        }
+        (*segment).data = grown;
+        (*segment).capacity = capacity;
+    }
+    memcpy((*segment).data + (*segment).size, data, len);
+    (*segment).size += len;
+    return 0;
+
+    error:
+    return 1;
+}
+
+static int hex_segment_cmp(const void *a, const void *b) {
+    uint64_t base_a = (*(const hex_segment *)a).base;
+    uint64_t base_b = (*(const hex_segment *)b).base;
+    return (base_a > base_b) - (base_a < base_b);
+}
+
+// SORT SEGMENTS BY ADDRESS AND MERGE TOUCHING ONES, LATER RECORDS WIN ON OVERLAP
+static uint8_t hex_image_merge(hex_image *image) {
+    size_t out = 0;
+
+    qsort((*image).segment, (*image).num_of_segments, sizeof(hex_segment), hex_segment_cmp);
+    for (size_t i = 1; i < (*image).num_of_segments; i++) {
+        hex_segment *last = &(*image).segment[out];
+        hex_segment *next = &(*image).segment[i];
+        if ((*next).base > (*last).base + (*last).size) {
+            (*image).segment[++out] = *next;
+            continue;
+        }
+        uint64_t end = (*next).base + (*next).size;
+        if (end > (*last).base + (*last).size) {
+            size_t size = end - (*last).base;
+            if (size > (*last).capacity) {
+                uint8_t *grown = realloc((*last).data, size);
+                if (grown == NULL) {
+                    goto error;
+                }
+                (*last).data = grown;
+                (*last).capacity = size;
             }
-            if ((*cd).succ & rv_fence_w) {
-                *tmp_ptr = 'w';
-                tmp_ptr++;
+            (*last).size = size;
+        }
+        memcpy((*last).data + ((*next).base - (*last).base), (*next).data, (*next).size);
+        free((*next).data);
+    }
+    if ((*image).num_of_segments > 0) {
+        (*image).num_of_segments = out + 1;
+    }
+    return 0;
+
+    error:
+    return 1;
+}
+
+// READ ALL DATA RECORDS OF THE MAPPED .HEX FILE INTO CONTIGUOUS SEGMENTS
+uint8_t hex_image_load(hex_image *image, hex_map *map) {
+    hex_string h_str;
+    hex_address address;
+
+    memset(image, 0, sizeof(*image));
+    memset(&address, 0, sizeof(address));
+    (*map).pos = 0;
+    while (!hex_map_eof(map)) {
+        if (read_next_str(&h_str, map)) {
+            goto error;
+        }
+        switch (h_str.flags) {
+        case 0x00:
+            if (hex_image_append(image, address.upper + h_str.offset, h_str.data, h_str.length)) {
+                goto error;
             }
             break;
-        case '\t':
-            *tmp_ptr = '\t';
-            tmp_ptr++;
-            break;
-        case 'A':
-            read_ptr = ".aq";
-            while (*read_ptr)
-            {
-                *tmp_ptr = *read_ptr;
-                tmp_ptr++;
-                read_ptr++;
-            }
+        case 0x01:
+            goto done;
+        default:
+            hex_address_update(&address, &h_str);
             break;
-        case 'R':
-            read_ptr = ".rl";
-            while (*read_ptr)
-            {
-                *tmp_ptr = *read_ptr;
-                tmp_ptr++;
-                read_ptr++;
+        }
+    }
+
+    done:
+    (*image).start = address.start;
+    (*image).has_start = address.has_start;
+    return hex_image_merge(image);
+
+    error:
+    return 1;
+}
+
+void hex_image_free(hex_image *image) {
+    for (size_t i = 0; i < (*image).num_of_segments; i++) {
+        if ((*image).segment[i].capacity != 0) {
+            free((*image).segment[i].data);
+        }
+    }
+    free((*image).segment);
+    memset(image, 0, sizeof(*image));
+}
+
+// SEGMENT HOLDING address OR NULL
+const hex_segment *hex_image_find(const hex_image *image, uint64_t address) {
+    size_t lo = 0;
+    size_t hi = (*image).num_of_segments;
+
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        const hex_segment *segment = &(*image).segment[mid];
+        if (address < (*segment).base) {
+            hi = mid;
+        } else if (address >= (*segment).base + (*segment).size) {
+            lo = mid + 1;
+        } else {
+            return segment;
+        }
+    }
+    return NULL;
+}
+
+//================================================================
+//========================== Hex Index ===========================
+//================================================================
+
+// DATA BYTES ONE INDEX ENTRY COVERS AT MOST, BOUNDS THE READ FOR A SMALL WINDOW
+#define HEX_INDEX_BLOCK     4096
+#define HEX_INDEX_MAGIC     "RVHEXIX2"
+
+// SIDECAR FILE: HEADER, THEN num_of_entries ENTRIES SORTED BY ADDRESS
+typedef struct {
+    char magic[8];
+    uint64_t file_size;
+    int64_t mtime_sec;
+    int64_t mtime_nsec;
+    uint64_t start;
+    uint64_t has_start;
+    uint64_t num_of_entries;
+} hex_index_header;
+
+static uint8_t hex_index_add(hex_index *index, uint64_t address, uint64_t file_offset) {
+    if ((*index).num_of_entries == (*index).capacity) {
+        size_t capacity = (*index).capacity ? 2 * (*index).capacity : 256;
+        hex_index_entry *grown = realloc((*index).entry, capacity * sizeof(hex_index_entry));
+        if (grown == NULL) {
+            return 1;
+        }
+        (*index).entry = grown;
+        (*index).capacity = capacity;
+    }
+    hex_index_entry *entry = &(*index).entry[(*index).num_of_entries++];
+    (*entry).address = address;
+    (*entry).size = 0;
+    (*entry).file_offset = file_offset;
+    return 0;
+}
+
+static int hex_index_cmp(const void *a, const void *b) {
+    uint64_t address_a = (*(const hex_index_entry *)a).address;
+    uint64_t address_b = (*(const hex_index_entry *)b).address;
+    return (address_a > address_b) - (address_a < address_b);
+}
+
+// ONE ENTRY PER HEX_INDEX_BLOCK BYTES OF CONSECUTIVE DATA RECORDS
+uint8_t hex_index_build(hex_index *index, hex_map *map) {
+    hex_string h_str;
+    hex_address address;
+    hex_index_entry *entry = NULL;
+
+    memset(index, 0, sizeof(*index));
+    memset(&address, 0, sizeof(address));
+    (*map).pos = 0;
+    while (!hex_map_eof(map)) {
+        size_t file_offset = (*map).pos;
+        if (read_next_str(&h_str, map)) {
+            goto error;
+        }
+        switch (h_str.flags) {
+        case 0x00:
+            if (entry == NULL || (*entry).address + (*entry).size != address.upper + h_str.offset ||
+                (*entry).size >= HEX_INDEX_BLOCK) {
+                if (hex_index_add(index, address.upper + h_str.offset, file_offset)) {
+                    goto error;
+                }
+                entry = &(*index).entry[(*index).num_of_entries - 1];
             }
+            (*entry).size += h_str.length;
             break;
+        case 0x01:
+            goto done;
         default:
+            hex_address_update(&address, &h_str);
+            entry = NULL;
             break;
         }
-        fmt++;
     }
-    printf("0x%.8x\t", (*cd).offset);
-    printf("%s\n", tmp);
+
+    done:
+    (*index).start = address.start;
+    (*index).has_start = address.has_start;
+    qsort((*index).entry, (*index).num_of_entries, sizeof(hex_index_entry), hex_index_cmp);
+    return 0;
+
+    error:
+    hex_index_free(index);
+    return 1;
 }
 
-//================================================================
-//======================= Main Function ==========================
-//================================================================
+static uint8_t hex_index_read(hex_index *index, const char *idx_path, const struct stat *st) {
+    hex_index_header header;
+    FILE *file = fopen(idx_path, "rb");
 
-int main(int argc, char** argv) {
-    if (argc < 3) {
-        printf("Usage: %s <hex_file> <rv32/rv64/rv128>\n", argv[0]);
+    memset(index, 0, sizeof(*index));
+    if (file == NULL) {
         goto error;
     }
+    if (fread(&header, sizeof(header), 1, file) != 1 ||
+        memcmp(header.magic, HEX_INDEX_MAGIC, sizeof(header.magic)) != 0 ||
+        header.file_size != (uint64_t)(*st).st_size || header.mtime_sec != (int64_t)(*st).st_mtim.tv_sec ||
+        header.mtime_nsec != (int64_t)(*st).st_mtim.tv_nsec || header.num_of_entries > (uint64_t)(*st).st_size) {
+        goto error_close;
+    }
+    (*index).entry = malloc((header.num_of_entries ? header.num_of_entries : 1) * sizeof(hex_index_entry));
+    if ((*index).entry == NULL ||
+        fread((*index).entry, sizeof(hex_index_entry), header.num_of_entries, file) != header.num_of_entries) {
+        goto error_free;
+    }
+    // A DAMAGED INDEX MUST NOT SEND read_next_str() OUT OF THE FILE OR BREAK THE SEARCH OF hex_index_load()
+    for (uint64_t i = 0; i < header.num_of_entries; i++) {
+        const hex_index_entry *entry = &(*index).entry[i];
+        if ((*entry).file_offset >= (uint64_t)(*st).st_size || (*entry).size >= HEX_INDEX_BLOCK + 256 ||
+            (i > 0 && (*entry).address < (*index).entry[i - 1].address)) {
+            goto error_free;
+        }
+    }
+    (*index).num_of_entries = (*index).capacity = header.num_of_entries;
+    (*index).start = header.start;
+    (*index).has_start = header.has_start != 0;
+    fclose(file);
+    return 0;
 
-    if ((strcmp(argv[2], "rv32") != 0) && (strcmp(argv[2], "rv64") != 0) && (strcmp(argv[2], "rv128") != 0)) {
-        printf("Usage: %s <hex_file> <rv32/rv64/rv128>\n", argv[0]);
-        goto error;
+    error_free:
+    hex_index_free(index);
+    error_close:
+    fclose(file);
+    error:
+    return 1;
+}
+
+static uint8_t hex_index_write(const hex_index *index, const char *idx_path, const struct stat *st) {
+    hex_index_header header;
+    FILE *file = fopen(idx_path, "wb");
+
+    if (file == NULL) {
+        return 1;
+    }
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, HEX_INDEX_MAGIC, sizeof(header.magic));
+    header.file_size = (*st).st_size;
+    header.mtime_sec = (*st).st_mtim.tv_sec;
+    header.mtime_nsec = (*st).st_mtim.tv_nsec;
+    header.start = (*index).start;
+    header.has_start = (*index).has_start;
+    header.num_of_entries = (*index).num_of_entries;
+    uint8_t err = fwrite(&header, sizeof(header), 1, file) != 1;
+    err |= fwrite((*index).entry, sizeof(hex_index_entry), (*index).num_of_entries, file) != (*index).num_of_entries;
+    err |= fclose(file) != 0;
+    if (err) {
+        unlink(idx_path);
     }
+    return err;
+}
+
+// INDEX OF THE .HEX FILE AT path FROM path.idx, REBUILT AND SAVED IF MISSING OR STALE
+uint8_t hex_index_open(hex_index *index, hex_map *map, const char *path) {
+    struct stat st;
+    size_t len = strlen(path);
+    char *idx_path = malloc(len + 5);
 
-    FILE *input;
-    if ((input = fopen(argv[1], "rb")) == NULL) {
-        printf("Can't open file.\n");
+    if (idx_path == NULL || stat(path, &st) != 0) {
         goto error;
     }
+    memcpy(idx_path, path, len);
+    memcpy(idx_path + len, ".idx", 5);
+    if (hex_index_read(index, idx_path, &st) != 0) {
+        if (hex_index_build(index, map)) {
+            goto error;
+        }
+        // A READ-ONLY DIRECTORY ONLY COSTS THE REBUILD NEXT TIME
+        hex_index_write(index, idx_path, &st);
+    }
+    free(idx_path);
+    return 0;
 
-    hex_string h_str;
-    //MAKE SURE
-    h_str.cur_ptr = 0;
-    h_str.destruct_flag = 0;
+    error:
+    free(idx_path);
+    return 1;
+}
 
-    //FIND START OFFSET
-    uint16_t r_cs = 0;
-    uint16_t r_ip = 0;
+void hex_index_free(hex_index *index) {
+    free((*index).entry);
+    memset(index, 0, sizeof(*index));
+}
 
-    while (h_str.flags != 0x01 && feof(input) == 0)
-    {
-        if (h_str.flags == 0x03) {
-            r_cs = h_str.data[0] << 8;
-            r_cs += h_str.data[1];
-            r_ip = h_str.data[2] << 8;
-            r_ip += h_str.data[3];
-            break;
+// LOAD ONLY THE RECORDS HOLDING [start, end) INTO image
+uint8_t hex_index_load(const hex_index *index, hex_map *map, uint64_t start, uint64_t end, hex_image *image) {
+    hex_string h_str;
+    size_t lo = 0;
+    size_t hi = (*index).num_of_entries;
+
+    memset(image, 0, sizeof(*image));
+    (*image).start = (*index).start;
+    (*image).has_start = (*index).has_start;
+    // FIRST ENTRY THAT MAY REACH start, ENTRIES HOLD LESS THAN HEX_INDEX_BLOCK + 256 BYTES
+    uint64_t from = (start > HEX_INDEX_BLOCK + 256) ? start - (HEX_INDEX_BLOCK + 256) : 0;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if ((*index).entry[mid].address < from) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    for (size_t i = lo; i < (*index).num_of_entries && (*index).entry[i].address < end; i++) {
+        const hex_index_entry *entry = &(*index).entry[i];
+        if ((*entry).address + (*entry).size <= start) {
+            continue;
         }
-        if (read_next_str(&h_str, input)) {
-            goto error_while_file_read;
+        uint64_t address = (*entry).address;
+        (*map).pos = (*entry).file_offset;
+        while (address < (*entry).address + (*entry).size) {
+            if (read_next_str(&h_str, map) || h_str.flags != 0x00) {
+                goto error;
+            }
+            if (hex_image_append(image, address, h_str.data, h_str.length)) {
+                goto error;
+            }
+            address += h_str.length;
         }
     }
-    
-    if (r_cs == 0 && r_ip == 0) {
-        goto error_while_file_read;
+    return hex_image_merge(image);
+
+    error:
+    return 1;
+}
+
+//================================================================
+//========================== ELF Image ===========================
+//================================================================
+
+#ifndef EM_RISCV
+#define EM_RISCV 243
+#endif
+
+uint8_t elf_detect(const hex_map *map) {
+    return (*map).size >= EI_NIDENT && memcmp((*map).data, ELFMAG, SELFMAG) == 0;
+}
+
+// ADD [offset, offset + size) OF THE FILE AT address WITHOUT COPYING IT
+static uint8_t elf_image_add(hex_image *image, const hex_map *map, uint64_t address, uint64_t offset,
+    uint64_t size) {
+    if (offset > (*map).size || size > (*map).size - offset) {
+        goto error;
+    }
+    if (size == 0) {
+        return 0;
+    }
+    if ((*image).num_of_segments == (*image).capacity) {
+        size_t capacity = (*image).capacity ? 2 * (*image).capacity : 16;
+        hex_segment *grown = realloc((*image).segment, capacity * sizeof(hex_segment));
+        if (grown == NULL) {
+            goto error;
+        }
+        (*image).segment = grown;
+        (*image).capacity = capacity;
     }
+    hex_segment *segment = &(*image).segment[(*image).num_of_segments++];
+    (*segment).base = address;
+    (*segment).data = (uint8_t *)(*map).data + offset;
+    (*segment).size = size;
+    (*segment).capacity = 0;
+    return 0;
+
+    error:
+    return 1;
+}
 
-    if(find_offset(&h_str, input, r_ip)) {
-        goto error_while_file_read;
+// SORT BORROWED SEGMENTS, JOIN NEIGHBOURS ADJACENT BOTH IN MEMORY AND IN THE FILE
+static void elf_image_sort(hex_image *image) {
+    size_t out = 0;
+
+    qsort((*image).segment, (*image).num_of_segments, sizeof(hex_segment), hex_segment_cmp);
+    for (size_t i = 1; i < (*image).num_of_segments; i++) {
+        hex_segment *last = &(*image).segment[out];
+        hex_segment *next = &(*image).segment[i];
+        if ((*next).base == (*last).base + (*last).size && (*next).data == (*last).data + (*last).size) {
+            (*last).size += (*next).size;
+        } else if ((*next).base >= (*last).base + (*last).size) {
+            (*image).segment[++out] = *next;
+        }
     }
+    if ((*image).num_of_segments > 0) {
+        (*image).num_of_segments = out + 1;
+    }
+}
 
-    command_data cd;
-    if (strcmp(argv[2], "rv32") == 0) {
-        cd.pc = rv32;
-    } else if (strcmp(argv[2], "rv64") == 0) {
-        cd.pc = rv64;
-    } else if (strcmp(argv[2], "rv128") == 0) {
-        cd.pc = rv128;
+// EXECUTABLE SECTIONS OF A RISC-V ELF, OR ITS EXECUTABLE PT_LOAD SEGMENTS WHEN
+// THERE ARE NO SECTION HEADERS; START IS e_entry, *pc COMES FROM EI_CLASS
+uint8_t elf_image_load(hex_image *image, const hex_map *map, uint8_t *pc) {
+    const uint8_t *ident = (*map).data;
+    uint64_t entry, phoff, shoff;
+    uint16_t machine, phentsize, phnum, shentsize, shnum;
+
+    memset(image, 0, sizeof(*image));
+    if (!elf_detect(map) || ident[EI_DATA] != ELFDATA2LSB) {
+        goto error;
+    }
+    if (ident[EI_CLASS] == ELFCLASS32 && (*map).size >= sizeof(Elf32_Ehdr)) {
+        Elf32_Ehdr ehdr;
+        memcpy(&ehdr, ident, sizeof(ehdr));
+        *pc = rv32;
+        machine = ehdr.e_machine;
+        entry = ehdr.e_entry;
+        phoff = ehdr.e_phoff;
+        phentsize = ehdr.e_phentsize;
+        phnum = ehdr.e_phnum;
+        shoff = ehdr.e_shoff;
+        shentsize = ehdr.e_shentsize;
+        shnum = ehdr.e_shnum;
+    } else if (ident[EI_CLASS] == ELFCLASS64 && (*map).size >= sizeof(Elf64_Ehdr)) {
+        Elf64_Ehdr ehdr;
+        memcpy(&ehdr, ident, sizeof(ehdr));
+        *pc = rv64;
+        machine = ehdr.e_machine;
+        entry = ehdr.e_entry;
+        phoff = ehdr.e_phoff;
+        phentsize = ehdr.e_phentsize;
+        phnum = ehdr.e_phnum;
+        shoff = ehdr.e_shoff;
+        shentsize = ehdr.e_shentsize;
+        shnum = ehdr.e_shnum;
     } else {
-        goto error_while_file_read;
+        goto error;
+    }
+    if (machine != EM_RISCV) {
+        printf("ERROR: NOT A RISC-V ELF\n");
+        goto error;
     }
 
-    printf("OFFSET\t\tCOMMAND\n");
-
-    cd.offset = h_str.offset + h_str.cur_ptr;
-    while ((cd.byte_data = get_next_command(&h_str, input)) != 0)
-    {
-        bp_opcode(&cd);
-        if (opcode_data[cd.opcode].parse_func != NULL) {
-            opcode_data[cd.opcode].parse_func(&cd);
-            print_decoded(&cd);
+    if (shoff != 0 && shoff <= (*map).size && (uint64_t)shnum * shentsize <= (*map).size - shoff &&
+        shentsize >= ((*pc == rv32) ? sizeof(Elf32_Shdr) : sizeof(Elf64_Shdr))) {
+        for (uint16_t i = 0; i < shnum; i++) {
+            const uint8_t *ptr = ident + shoff + (uint64_t)i * shentsize;
+            uint64_t type, flags, address, offset, size;
+            if (*pc == rv32) {
+                Elf32_Shdr shdr;
+                memcpy(&shdr, ptr, sizeof(shdr));
+                type = shdr.sh_type;
+                flags = shdr.sh_flags;
+                address = shdr.sh_addr;
+                offset = shdr.sh_offset;
+                size = shdr.sh_size;
+            } else {
+                Elf64_Shdr shdr;
+                memcpy(&shdr, ptr, sizeof(shdr));
+                type = shdr.sh_type;
+                flags = shdr.sh_flags;
+                address = shdr.sh_addr;
+                offset = shdr.sh_offset;
+                size = shdr.sh_size;
+            }
+            if (type == SHT_PROGBITS && (flags & SHF_EXECINSTR) &&
+                elf_image_add(image, map, address, offset, size)) {
+                goto error;
+            }
         }
-        cd.offset = h_str.offset + h_str.cur_ptr;
     }
-    
+    if ((*image).num_of_segments == 0 && phoff != 0 && phoff <= (*map).size &&
+        (uint64_t)phnum * phentsize <= (*map).size - phoff &&
+        phentsize >= ((*pc == rv32) ? sizeof(Elf32_Phdr) : sizeof(Elf64_Phdr))) {
+        for (uint16_t i = 0; i < phnum; i++) {
+            const uint8_t *ptr = ident + phoff + (uint64_t)i * phentsize;
+            uint64_t type, flags, address, offset, size;
+            if (*pc == rv32) {
+                Elf32_Phdr phdr;
+                memcpy(&phdr, ptr, sizeof(phdr));
+                type = phdr.p_type;
+                flags = phdr.p_flags;
+                address = phdr.p_vaddr;
+                offset = phdr.p_offset;
+                size = phdr.p_filesz;
+            } else {
+                Elf64_Phdr phdr;
+                memcpy(&phdr, ptr, sizeof(phdr));
+                type = phdr.p_type;
+                flags = phdr.p_flags;
+                address = phdr.p_vaddr;
+                offset = phdr.p_offset;
+                size = phdr.p_filesz;
+            }
+            if (type == PT_LOAD && (flags & PF_X) && elf_image_add(image, map, address, offset, size)) {
+                goto error;
+            }
+        }
+    }
+    elf_image_sort(image);
 
-    fclose(input);
+    // A RELOCATABLE OBJECT HAS NO ENTRY, START AT ITS FIRST CODE
+    (*image).start = entry;
+    if (hex_image_find(image, entry) == NULL && (*image).num_of_segments > 0) {
+        (*image).start = (*image).segment[0].base;
+    }
+    (*image).has_start = (*image).num_of_segments > 0;
     return 0;
 
-    error_while_file_read:
-    printf("ERROR: ERROR WHILE FILE READ\n");
-    fclose(input);
     error:
     return 1;
 }
 
 //================================================================
+//======================== Symbol Table ==========================
 //================================================================
-//================================================================
-// GET HEX BYTE FROM .HEX FILE STRING
-uint8_t fgetc_hex(FILE *file) {
-    uint8_t hex = 0;
-    hex = str_byte_to_hex(fgetc(file)) << 4;
-    hex += str_byte_to_hex(fgetc(file));
-    return hex;
+
+void symbol_table_init(symbol_table *table) {
+    memset(table, 0, sizeof(*table));
+}
+
+void symbol_table_free(symbol_table *table) {
+    free((*table).entry);
+    free((*table).names);
+    symbol_table_init(table);
 }
 
-// GET HEX STRING FROM .HEX FILE STRING
-uint8_t fgets_hex(uint8_t* buf, size_t num, FILE *file) {
-    for (size_t i = 0; i < num; i++) {
-        *buf = fgetc_hex(file);
-        buf++;
+// size 0 - UP TO THE NEXT SYMBOL
+static uint8_t symbol_table_add(symbol_table *table, uint64_t start, uint64_t size, const char *name, size_t len) {
+    if ((*table).num_of_entries == (*table).capacity) {
+        size_t capacity = (*table).capacity ? 2 * (*table).capacity : 256;
+        symbol *grown = realloc((*table).entry, capacity * sizeof(symbol));
+        if (grown == NULL) {
+            goto error;
+        }
+        (*table).entry = grown;
+        (*table).capacity = capacity;
+    }
+    while ((*table).names_size + len + 1 > (*table).names_capacity) {
+        size_t capacity = (*table).names_capacity ? 2 * (*table).names_capacity : 4096;
+        char *grown = realloc((*table).names, capacity);
+        if (grown == NULL) {
+            goto error;
+        }
+        (*table).names = grown;
+        (*table).names_capacity = capacity;
+    }
+    symbol *sym = &(*table).entry[(*table).num_of_entries++];
+    (*sym).start = start;
+    (*sym).end = (size != 0 && start + size > start) ? start + size : 0;
+    (*sym).name = (*table).names_size;
+    memcpy((*table).names + (*table).names_size, name, len);
+    (*table).names[(*table).names_size + len] = '\0';
+    (*table).names_size += len + 1;
+    if (len > (*table).longest_name) {
+        (*table).longest_name = len;
     }
+    return 0;
+
+    error:
+    return 1;
 }
 
-// TRANSLATE .HEX FILE STRING BYTE(2 char) TO HEX FORMAT
-uint8_t str_byte_to_hex(uint8_t str_byte) {
-    if ((0x30 <= str_byte) && (str_byte <= 0x39)) {
-        return str_byte - 0x30;
-    } else if ((0x41 <= str_byte) && (str_byte <= 0x46)) {
-        return str_byte - 0x37;
-    } else if ((0x61 <= str_byte) && (str_byte <= 0x66)) {
-        return str_byte - 0x57;
+// BY START, THEN IN THE ORDER THEY WERE ADDED
+static int symbol_cmp(const void *a, const void *b) {
+    const symbol *x = a;
+    const symbol *y = b;
+
+    if ((*x).start != (*y).start) {
+        return ((*x).start > (*y).start) ? 1 : -1;
     }
+    return ((*x).name > (*y).name) - ((*x).name < (*y).name);
 }
 
-uint32_t get_next_command(hex_string *h_str, FILE *file) {
+// SORT, KEEP THE FIRST SYMBOL OF EVERY START AND CUT EACH ONE AT THE NEXT
+static void symbol_table_sort(symbol_table *table) {
+    size_t out = 0;
 
-    uint32_t data = 0;
-    uint8_t num_of_bytes_to_read;
-    if ((*h_str).cur_ptr == (*h_str).length) {
-        read_next_str(h_str, file);
+    qsort((*table).entry, (*table).num_of_entries, sizeof(symbol), symbol_cmp);
+    for (size_t i = 1; i < (*table).num_of_entries; i++) {
+        if ((*table).entry[i].start != (*table).entry[out].start) {
+            (*table).entry[++out] = (*table).entry[i];
+        }
     }
-    data = (*h_str).data[(*h_str).cur_ptr];
-    (*h_str).cur_ptr = (*h_str).cur_ptr + 1;
+    if ((*table).num_of_entries > 0) {
+        (*table).num_of_entries = out + 1;
+    }
+    for (size_t i = 0; i < (*table).num_of_entries; i++) {
+        symbol *sym = &(*table).entry[i];
+        uint64_t next = (i + 1 < (*table).num_of_entries) ? (*table).entry[i + 1].start : UINT64_MAX;
+        if ((*sym).end == 0 || (*sym).end > next) {
+            (*sym).end = next;
+        }
+    }
+    (*table).cursor = 0;
+}
 
+// SECTION HEADER index OF AN ELF WITH shnum HEADERS AT shoff, 1 IF IT AND ITS DATA ARE INSIDE THE FILE
+static uint8_t symbol_section(const hex_map *map, uint8_t is32, uint64_t shoff, uint16_t shentsize, uint16_t shnum,
+    uint64_t index, uint64_t *type, uint64_t *link, uint64_t *offset, uint64_t *size) {
+    const uint8_t *ptr = (*map).data + shoff + index * shentsize;
 
-    if ((data & 0b11) != 0b11)
-    {
-        num_of_bytes_to_read = 2;
+    if (index >= shnum) {
+        return 0;
+    }
+    if (is32) {
+        Elf32_Shdr shdr;
+        memcpy(&shdr, ptr, sizeof(shdr));
+        *type = shdr.sh_type;
+        *link = shdr.sh_link;
+        *offset = shdr.sh_offset;
+        *size = shdr.sh_size;
     } else {
-        num_of_bytes_to_read = 4;
+        Elf64_Shdr shdr;
+        memcpy(&shdr, ptr, sizeof(shdr));
+        *type = shdr.sh_type;
+        *link = shdr.sh_link;
+        *offset = shdr.sh_offset;
+        *size = shdr.sh_size;
     }
+    return *offset <= (*map).size && *size <= (*map).size - *offset;
+}
 
-    for (int i = 1; i < num_of_bytes_to_read; i++) {
-        if ((*h_str).cur_ptr == (*h_str).length) {
-            read_next_str(h_str, file);
-        }
-        data += ((*h_str).data[(*h_str).cur_ptr]) << (8 * i);
-        (*h_str).cur_ptr = (*h_str).cur_ptr + 1;
+// FUNCTION AND UNTYPED SYMBOLS OF THE .symtab OF AN ELF, RISC-V MAPPING SYMBOLS ($x, $d) LEFT OUT
+uint8_t symbol_table_load_elf(symbol_table *table, const hex_map *map) {
+    const uint8_t *ident = (*map).data;
+    uint64_t shoff;
+    uint16_t shentsize, shnum;
+    uint8_t is32;
+
+    symbol_table_init(table);
+    if (!elf_detect(map) || ident[EI_DATA] != ELFDATA2LSB) {
+        goto error;
+    }
+    if (ident[EI_CLASS] == ELFCLASS32 && (*map).size >= sizeof(Elf32_Ehdr)) {
+        Elf32_Ehdr ehdr;
+        memcpy(&ehdr, ident, sizeof(ehdr));
+        is32 = 1;
+        shoff = ehdr.e_shoff;
+        shentsize = ehdr.e_shentsize;
+        shnum = ehdr.e_shnum;
+    } else if (ident[EI_CLASS] == ELFCLASS64 && (*map).size >= sizeof(Elf64_Ehdr)) {
+        Elf64_Ehdr ehdr;
+        memcpy(&ehdr, ident, sizeof(ehdr));
+        is32 = 0;
+        shoff = ehdr.e_shoff;
+        shentsize = ehdr.e_shentsize;
+        shnum = ehdr.e_shnum;
+    } else {
+        goto error;
+    }
+    // NO SECTION HEADERS - NO SYMBOLS
+    if (shoff == 0 || shoff > (*map).size || (uint64_t)shnum * shentsize > (*map).size - shoff ||
+        shentsize < (is32 ? sizeof(Elf32_Shdr) : sizeof(Elf64_Shdr))) {
+        return 0;
     }
 
-    switch (data)
-    {
-    case 0b01:
-        (*h_str).destruct_flag = 1;
-        break;
-    case 0b10:
-        if ((*h_str).destruct_flag == 1) {
-            goto error;
+    for (uint16_t i = 0; i < shnum; i++) {
+        uint64_t type, link, offset, size;
+        uint64_t str_type, str_link, str_offset, str_size;
+        if (!symbol_section(map, is32, shoff, shentsize, shnum, i, &type, &link, &offset, &size) ||
+            type != SHT_SYMTAB ||
+            !symbol_section(map, is32, shoff, shentsize, shnum, link, &str_type, &str_link, &str_offset,
+                &str_size) || str_type != SHT_STRTAB) {
+            continue;
+        }
+        const char *strtab = (const char *)ident + str_offset;
+        size_t entsize = is32 ? sizeof(Elf32_Sym) : sizeof(Elf64_Sym);
+        for (uint64_t pos = 0; pos + entsize <= size; pos += entsize) {
+            uint64_t name, value, sym_size;
+            uint8_t info;
+            uint16_t shndx;
+            if (is32) {
+                Elf32_Sym sym;
+                memcpy(&sym, ident + offset + pos, sizeof(sym));
+                name = sym.st_name;
+                value = sym.st_value;
+                sym_size = sym.st_size;
+                info = sym.st_info;
+                shndx = sym.st_shndx;
+            } else {
+                Elf64_Sym sym;
+                memcpy(&sym, ident + offset + pos, sizeof(sym));
+                name = sym.st_name;
+                value = sym.st_value;
+                sym_size = sym.st_size;
+                info = sym.st_info;
+                shndx = sym.st_shndx;
+            }
+            if (shndx == SHN_UNDEF || shndx == SHN_ABS || name == 0 || name >= str_size ||
+                (ELF32_ST_TYPE(info) != STT_FUNC && ELF32_ST_TYPE(info) != STT_NOTYPE) || strtab[name] == '$') {
+                continue;
+            }
+            if (symbol_table_add(table, value, sym_size, strtab + name, strnlen(strtab + name, str_size - name))) {
+                goto error;
+            }
         }
-        break;
-    case 0b00:
-        printf("================END OF SEGMENT================\n");
-        data = 0b101; // MAKE NOP INSTEAD OF ERROR
-    default:
-        (*h_str).destruct_flag = 0;
-        break;
     }
-        
-    return data;
+    symbol_table_sort(table);
+    return 0;
 
     error:
-    return 0;
+    symbol_table_free(table);
+    return 1;
 }
 
-uint8_t read_next_str(hex_string* h_str, FILE *file) {
-    if (((*h_str).legit = fgetc(file)) == ':')
-    {
-        (*h_str).length = fgetc_hex(file);
-        (*h_str).offset = fgetc_hex(file) << 8;
-        (*h_str).offset += fgetc_hex(file);
-        (*h_str).flags = fgetc_hex(file);
-        fgets_hex((*h_str).data, (*h_str).length, file);
-        (*h_str).checksum = fgetc_hex(file);
-        (*h_str).cur_ptr = 0;
-        // IGNORE '\n'
-        while (fgetc(file) != 0x0a);
+static uint8_t symbol_hex_digit(uint8_t c, uint8_t *value) {
+    if (c >= '0' && c <= '9') {
+        *value = c - '0';
+    } else if ((c | 0x20) >= 'a' && (c | 0x20) <= 'f') {
+        *value = (c | 0x20) - 'a' + 10;
+    } else {
         return 0;
     }
+    return 1;
+}
 
-    error:
+// HEX NUMBER AT *ptr FOLLOWED BY SPACES, 0 IF THERE IS NONE
+static uint8_t symbol_hex_field(const uint8_t **ptr, const uint8_t *end, uint64_t *value) {
+    const uint8_t *p = *ptr;
+    uint8_t digit;
+
+    *value = 0;
+    while (p < end && symbol_hex_digit(*p, &digit)) {
+        *value = (*value << 4) | digit;
+        p++;
+    }
+    if (p == *ptr || p == end || (*p != ' ' && *p != '\t')) {
+        return 0;
+    }
+    while (p < end && (*p == ' ' || *p == '\t')) {
+        p++;
+    }
+    *ptr = p;
     return 1;
 }
 
-uint8_t find_offset(hex_string *h_str, FILE *file, uint16_t offset) {
-    fseek(file, 0, SEEK_SET);
-    do {
-        read_next_str(h_str, file);
-        if ( ((*h_str).offset <= offset) && (((*h_str).offset + (*h_str).length) > offset)) {
-            (*h_str).cur_ptr = offset - (*h_str).offset;
-            return 0;
+// nm OR nm -S OUTPUT, "<address> [<size>] <type> <name>" LINES, CODE SYMBOLS (TYPE t, T, w, W) ONLY
+uint8_t symbol_table_load_nm(symbol_table *table, const hex_map *map) {
+    const uint8_t *ptr = (*map).data;
+    const uint8_t *end = (*map).data + (*map).size;
+
+    symbol_table_init(table);
+    while (ptr < end) {
+        const uint8_t *line_end = memchr(ptr, '\n', end - ptr);
+        if (line_end == NULL) {
+            line_end = end;
+        }
+        const uint8_t *field = ptr;
+        uint64_t address, size = 0;
+        if (symbol_hex_field(&field, line_end, &address)) {
+            const uint8_t *size_field = field;
+            if (symbol_hex_field(&size_field, line_end, &size) && size_field - field > 2) {
+                field = size_field;
+            } else {
+                size = 0;
+            }
+            uint8_t type = *field;
+            const uint8_t *name = field + 1;
+            while (name < line_end && (*name == ' ' || *name == '\t')) {
+                name++;
+            }
+            const uint8_t *name_end = line_end;
+            while (name_end > name && (name_end[-1] == '\r' || name_end[-1] == ' ')) {
+                name_end--;
+            }
+            if ((type | 0x20) != 't' && (type | 0x20) != 'w') {
+                name_end = name;
+            }
+            if (name_end > name && name > field + 1 &&
+                symbol_table_add(table, address, size, (const char *)name, name_end - name)) {
+                goto error;
+            }
         }
-    }   while (feof(file) == 0);
-    fseek(file, 0, SEEK_SET);
-    printf("ERROR: CAN'T FIND OFFSET");
+        ptr = line_end + 1;
+    }
+    symbol_table_sort(table);
+    return 0;
+
+    error:
+    symbol_table_free(table);
     return 1;
 }
 
+// SYMBOL HOLDING address, BINARY SEARCH
+const symbol *symbol_find(const symbol_table *table, uint64_t address) {
+    size_t lo = 0;
+    size_t hi = (*table).num_of_entries;
+
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if ((*table).entry[mid].start <= address) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    if (lo == 0 || address >= (*table).entry[lo - 1].end) {
+        return NULL;
+    }
+    return &(*table).entry[lo - 1];
+}
+
+// symbol_find() FOR ADDRESSES THAT MOSTLY GROW, THE CURSOR ONLY STEPS FORWARD BETWEEN THEM
+const symbol *symbol_at(symbol_table *table, uint64_t address) {
+    size_t i = (*table).cursor;
+
+    if (i >= (*table).num_of_entries || (*table).entry[i].start > address) {
+        const symbol *sym = symbol_find(table, address);
+        if (sym != NULL) {
+            (*table).cursor = sym - (*table).entry;
+        }
+        return sym;
+    }
+    while (i + 1 < (*table).num_of_entries && (*table).entry[i + 1].start <= address) {
+        i++;
+    }
+    (*table).cursor = i;
+    return (address < (*table).entry[i].end) ? &(*table).entry[i] : NULL;
+}
+
 void bp_opcode(command_data* cd) {
     rv_isa isa = (*cd).pc;
     rv_op op = op_illegal;
@@ -1682,14 +4543,14 @@ void bp_opcode(command_data* cd) {
             op = op_c_lw;
             break;
         case 0b011:
-            if (isa = rv32) {
+            if (isa == rv32) {
                 op = op_c_flw;
             } else {
                 op = op_c_ld;
             }
             break;
         case 0b101:
-            if (isa = rv128) {
+            if (isa == rv128) {
                 op = op_c_sq;
             } else {
                 op = op_c_fsd;
@@ -1699,7 +4560,7 @@ void bp_opcode(command_data* cd) {
             op = op_c_sw;
             break;
         case 0b111:
-            if (isa = rv32) {
+            if (isa == rv32) {
                 op = op_c_fsw;
             } else {
                 op = op_c_sd;
@@ -1721,7 +4582,7 @@ void bp_opcode(command_data* cd) {
                 }
                 break;
             case 0b001:
-                if (isa = rv32) {
+                if (isa == rv32) {
                     op = op_c_jal;
                 } else {
                     op = op_c_addiw;
@@ -1796,7 +4657,7 @@ void bp_opcode(command_data* cd) {
             op = op_c_slli;
             break;
         case 0b001:
-            if (isa = rv128) {
+            if (isa == rv128) {
                 op = op_c_lqsp;
             } else {
                 op = op_c_fldsp;
@@ -1806,7 +4667,7 @@ void bp_opcode(command_data* cd) {
             op = op_c_lwsp;
             break;
         case 0b011:
-            if (isa = rv32) {
+            if (isa == rv32) {
                 op = op_c_flwsp;
             } else {
                 op = op_c_ldsp;
@@ -1832,7 +4693,7 @@ void bp_opcode(command_data* cd) {
             }
             break;
         case 0b101:
-            if (isa = rv128) {
+            if (isa == rv128) {
                 op = op_c_sqsp;
             } else {
                 op = op_c_fsdsp;
@@ -1842,7 +4703,7 @@ void bp_opcode(command_data* cd) {
             op = op_c_swsp;
             break;
         case 0b111:
-            if (isa = rv32) {
+            if (isa == rv32) {
                 op = op_c_fswsp;
             } else {
                 op = op_c_sdsp;
@@ -2824,4 +5685,31 @@ void bp_opcode(command_data* cd) {
         break;
     }
     (*cd).opcode = op;
-}
\ No newline at end of file
+}
+
+void bp_opcode_table(command_data* cd) {
+    (*cd).opcode = decode_op(&decode_tables[(*cd).pc], (*cd).byte_data);
+}
+
+// RUN BOTH DECODERS OVER EVERY 16-BIT PARCEL, RETURN NUMBER OF MISMATCHES
+uint32_t decode_table_check(uint8_t pc) {
+    command_data cd_switch;
+    command_data cd_table;
+    uint32_t mismatches = 0;
+
+    cd_switch.pc = cd_table.pc = pc;
+    for (uint32_t parcel = 0; parcel <= 0xffff; parcel++) {
+        if ((parcel & 0b11) == 0b11) {
+            continue;
+        }
+        cd_switch.byte_data = cd_table.byte_data = parcel;
+        bp_opcode(&cd_switch);
+        bp_opcode_table(&cd_table);
+        if (cd_switch.opcode != cd_table.opcode) {
+            printf("ERROR: DECODER MISMATCH 0x%04x\t%s\t%s\n", parcel,
+                opcode_data[cd_switch.opcode].name, opcode_data[cd_table.opcode].name);
+            mismatches++;
+        }
+    }
+    return mismatches;
+}
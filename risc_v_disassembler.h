@@ -1,3 +1,14 @@
+#ifndef RISC_V_DISASSEMBLER_H
+#define RISC_V_DISASSEMBLER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "risc_v_opcodes.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 typedef enum {
     rv32,
     rv64,
@@ -20,294 +31,85 @@ typedef enum {
     rv_fence_w = 1,
 } rv_fence;
 
-typedef enum {
-    op_illegal,
-    op_c_addi4spn,
-    op_c_fld,
-    op_c_lq,
-    op_c_lw,
-    op_c_flw,
-    op_c_ld,
-    op_c_fsd,
-    op_c_sq,
-    op_c_sw,
-    op_c_fsw,
-    op_c_sd,
-    op_c_nop,
-    op_c_addi,
-    op_c_jal,
-    op_c_addiw,
-    op_c_li,
-    op_c_addi16sp,
-    op_c_lui,
-    op_c_srli,
-    op_c_srai,
-    op_c_andi,
-    op_c_sub,
-    op_c_xor,
-    op_c_or,
-    op_c_and,
-    op_c_subw,
-    op_c_addw,
-    op_c_j,
-    op_c_beqz,
-    op_c_bnez,
-    op_c_slli,
-    op_c_fldsp,
-    op_c_lqsp,
-    op_c_lwsp,
-    op_c_flwsp,
-    op_c_ldsp,
-    op_c_jr,
-    op_c_mv,
-    op_c_ebreak,
-    op_c_jalr,
-    op_c_add,
-    op_c_fsdsp,
-    op_c_sqsp,
-    op_c_swsp,
-    op_c_fswsp,
-    op_c_sdsp,
-    op_lui,
-    op_auipc,
-    op_jal,
-    op_jalr,
-    op_beq,
-    op_bne,
-    op_blt,
-    op_bge,
-    op_bltu,
-    op_bgeu,
-    op_lb,
-    op_lh,
-    op_lw,
-    op_lbu,
-    op_lhu,
-    op_sb,
-    op_sh,
-    op_sw,
-    op_addi,
-    op_slti,
-    op_sltiu,
-    op_xori,
-    op_ori,
-    op_andi,
-    op_slli,
-    op_srli,
-    op_srai,
-    op_add,
-    op_sub,
-    op_sll,
-    op_slt,
-    op_sltu,
-    op_xor,
-    op_srl,
-    op_sra,
-    op_or,
-    op_and,
-    op_fence,
-    op_ecall,
-    op_ebreak,
-    op_lwu,
-    op_ld,
-    op_sd,
-    op_addiw,
-    op_slliw,
-    op_srliw,
-    op_sraiw,
-    op_addw,
-    op_subw,
-    op_sllw,
-    op_srlw,
-    op_sraw,
-    op_fence_i,
-    op_csrrw,
-    op_csrrs,
-    op_csrrc,
-    op_csrrwi,
-    op_csrrsi,
-    op_csrrci,
-    op_mul,
-    op_mulh,
-    op_mulhsu,
-    op_mulhu,
-    op_div,
-    op_divu,
-    op_rem,
-    op_remu,
-    op_mulw,
-    op_divw,
-    op_divuw,
-    op_remw,
-    op_remuw,
-    op_lr_w,
-    op_sc_w,
-    op_amoswap_w,
-    op_amoadd_w,
-    op_amoxor_w,
-    op_amoand_w,
-    op_amoor_w,
-    op_amomin_w,
-    op_amomax_w,
-    op_amominu_w,
-    op_amomaxu_w,
-    op_lr_d,
-    op_sc_d,
-    op_amoswap_d,
-    op_amoadd_d,
-    op_amoxor_d,
-    op_amoand_d,
-    op_amoor_d,
-    op_amomin_d,
-    op_amomax_d,
-    op_amominu_d,
-    op_amomaxu_d,
-    op_flw,
-    op_fsw,
-    op_fmadd_s,
-    op_fmsub_s,
-    op_fnmsub_s,
-    op_fnmadd_s,
-    op_fadd_s,
-    op_fsub_s,
-    op_fmul_s,
-    op_fdiv_s,
-    op_fsqrt_s,
-    op_fsgnj_s,
-    op_fsgnjn_s,
-    op_fsgnjx_s,
-    op_fmin_s,
-    op_fmax_s,
-    op_fcvt_w_s,
-    op_fcvt_wu_s,
-    op_fmv_x_w,
-    op_feq_s,
-    op_flt_s,
-    op_fle_s,
-    op_fclass_s,
-    op_fcvt_s_w,
-    op_fcvt_s_wu,
-    op_fmv_w_x,
-    op_fcvt_l_s,
-    op_fcvt_lu_s,
-    op_fcvt_s_l,
-    op_fcvt_s_lu,
-    op_fld,
-    op_fsd,
-    op_fmadd_d,
-    op_fmsub_d,
-    op_fnmsub_d,
-    op_fnmadd_d,
-    op_fadd_d,
-    op_fsub_d,
-    op_fmul_d,
-    op_fdiv_d,
-    op_fsqrt_d,
-    op_fsgnj_d,
-    op_fsgnjn_d,
-    op_fsgnjx_d,
-    op_fmin_d,
-    op_fmax_d,
-    op_fcvt_s_d,
-    op_fcvt_d_s,
-    op_feq_d,
-    op_flt_d,
-    op_fle_d,
-    op_fclass_d,
-    op_fcvt_w_d,
-    op_fcvt_wu_d,
-    op_fcvt_d_w,
-    op_fcvt_d_wu,
-    op_fcvt_l_d,
-    op_fcvt_lu_d,
-    op_fmv_x_d,
-    op_fcvt_d_l,
-    op_fcvt_d_lu,
-    op_fmv_d_x,
-    op_flq,
-    op_fsq,
-    op_fmadd_q,
-    op_fmsub_q,
-    op_fnmsub_q,
-    op_fnmadd_q,
-    op_fadd_q,
-    op_fsub_q,
-    op_fmul_q,
-    op_fdiv_q,
-    op_fsqrt_q,
-    op_fsgnj_q,
-    op_fsgnjn_q,
-    op_fsgnjx_q,
-    op_fmin_q,
-    op_fmax_q,
-    op_fcvt_s_q,
-    op_fcvt_q_s,
-    op_fcvt_d_q,
-    op_fcvt_q_d,
-    op_feq_q,
-    op_flt_q,
-    op_fle_q,
-    op_fclass_q,
-    op_fcvt_w_q,
-    op_fcvt_wu_q,
-    op_fcvt_q_w,
-    op_fcvt_q_wu,
-    op_fcvt_l_q,
-    op_fcvt_lu_q,
-    op_fcvt_q_l,
-    op_fcvt_q_lu,
-    op_flh,
-    op_fsh,
-    op_fmadd_h,
-    op_fmsub_h,
-    op_fnmsub_h,
-    op_fnmadd_h,
-    op_fadd_h,
-    op_fsub_h,
-    op_fmul_h,
-    op_fdiv_h,
-    op_fsqrt_h,
-    op_fsgnj_h,
-    op_fsgnjn_h,
-    op_fsgnjx_h,
-    op_fmin_h,
-    op_fmax_h,
-    op_fcvt_s_h,
-    op_fcvt_h_s,
-    op_fcvt_d_h,
-    op_fcvt_h_d,
-    op_fcvt_q_h,
-    op_fcvt_h_q,
-    op_feq_h,
-    op_flt_h,
-    op_fle_h,
-    op_fclass_h,
-    op_fcvt_w_h,
-    op_fcvt_wu_h,
-    op_fmv_x_h,
-    op_fcvt_h_w,
-    op_fcvt_h_wu,
-    op_fmv_h_x,
-    op_fcvt_l_h,
-    op_fcvt_lu_h,
-    op_fcvt_h_l,
-    op_fcvt_h_lu,
-    op_wrs_nto,
-    op_wrs_sto
-} rv_op;
-
 typedef struct {
     uint8_t legit;
     uint8_t length;
     uint16_t offset;
     uint8_t flags;
-    uint8_t data[16];
+    uint8_t data[255];
     uint8_t checksum;
     //
     uint8_t cur_ptr;
     uint8_t destruct_flag;
 } hex_string;
 
+// Address state of a .hex file: upper bits from the last 02/04 record, start from 03/05
+typedef struct {
+    uint64_t upper;
+    uint64_t start;
+    uint8_t has_start;
+} hex_address;
+
+// .hex file mapped into memory, pos - start of the next record
+typedef struct {
+    const uint8_t *data;
+    size_t size;
+    size_t pos;
+} hex_map;
+
+// Contiguous bytes of the image starting at base, capacity 0 - data borrowed from the mapped file
+typedef struct {
+    uint64_t base;
+    uint8_t *data;
+    size_t size;
+    size_t capacity;
+} hex_segment;
+
+// All data records of a .hex file, segments sorted by base and not touching
+typedef struct {
+    hex_segment *segment;
+    size_t num_of_segments;
+    size_t capacity;
+    uint64_t start;
+    uint8_t has_start;
+} hex_image;
+
+// Consecutive data records [address, address + size) starting at file_offset of the .hex file
+typedef struct {
+    uint64_t address;
+    uint64_t size;
+    uint64_t file_offset;
+} hex_index_entry;
+
+// Sidecar index of a .hex file, entries sorted by address
+typedef struct {
+    hex_index_entry *entry;
+    size_t num_of_entries;
+    size_t capacity;
+    uint64_t start;
+    uint8_t has_start;
+} hex_index;
+
+// Window of a segment the decoder walks, pos - next command
+typedef struct {
+    const uint8_t *data;
+    size_t size;
+    size_t pos;
+    uint64_t base;
+    uint8_t destruct_flag;
+    // zero parcel replaced by nop, caller prints END OF SEGMENT
+    uint8_t segment_end;
+} code_span;
+
+// Output buffer flushed by write(2) to fd, or the mapped output file itself
+typedef struct {
+    char *buf;
+    size_t size;
+    size_t len;
+    int fd;
+    uint8_t mapped;
+} out_sink;
+
 typedef struct {
     uint64_t offset;
     // pc 0 - rv32, 1 - rv64, 2 - rv128 
@@ -329,6 +131,67 @@ typedef struct {
     uint8_t rl;
 } command_data;
 
+// Decoded commands as parallel arrays of the narrowest types that hold them
+typedef struct {
+    uint64_t base;
+    uint8_t pc;
+    // byte offset of every command from base
+    uint32_t *offset;
+    int32_t *imm;
+    uint16_t *opcode;
+    // rm, aq, rl, pred and succ packed by BATCH_ATTR
+    uint16_t *attr;
+    uint8_t *rd;
+    uint8_t *rs1;
+    uint8_t *rs2;
+    uint8_t *rs3;
+    // 2 or 4
+    uint8_t *length;
+    size_t num_of_cmds;
+    size_t capacity;
+} command_batch;
+
+#define BATCH_ATTR(rm, aq, rl, pred, succ) \
+    (uint16_t)(((rm) & 0x7) | (((aq) & 1) << 3) | (((rl) & 1) << 4) | (((pred) & 0xf) << 5) | (((succ) & 0xf) << 9))
+
+enum {
+    cfg_edge_fallthrough,
+    cfg_edge_taken,
+    cfg_edge_jump,
+    cfg_edge_call
+};
+
+// Basic blocks over a sorted command array, successors in compressed sparse row form
+typedef struct {
+    size_t num_of_blocks;
+    size_t num_of_edges;
+    // block b holds commands [first[b], first[b + 1])
+    uint32_t *first;
+    // successors of block b are succ[edge_index[b] .. edge_index[b + 1]), kind - cfg_edge_*
+    uint32_t *edge_index;
+    uint32_t *succ;
+    uint8_t *kind;
+} cfg_graph;
+
+// Named address range [start, end), name - offset of its NUL-terminated name in names
+typedef struct {
+    uint64_t start;
+    uint64_t end;
+    uint32_t name;
+} symbol;
+
+// Symbols sorted by start and not overlapping, cursor - where the last symbol_at() stopped
+typedef struct {
+    symbol *entry;
+    size_t num_of_entries;
+    size_t capacity;
+    char *names;
+    size_t names_size;
+    size_t names_capacity;
+    size_t longest_name;
+    size_t cursor;
+} symbol_table;
+
 typedef enum {
     rv_reg_zero,
     rv_reg_ra,
@@ -364,13 +227,101 @@ typedef enum {
     rv_reg_t6,
 } rv_reg;
 
-uint8_t fgetc_hex(FILE *file);
-uint8_t fgets_hex(uint8_t* buf, size_t num, FILE *file);
+uint8_t hex_map_open(hex_map *map, const char *path);
+void hex_map_close(hex_map *map);
+uint8_t hex_map_eof(const hex_map *map);
 uint8_t str_byte_to_hex(uint8_t str_byte);
+void hex_record_init(void);
+
+uint32_t get_next_command(code_span *span);
+uint8_t read_next_str(hex_string *h_str, hex_map *map);
+
+void hex_address_update(hex_address *address, const hex_string *h_str);
+uint8_t hex_image_load(hex_image *image, hex_map *map);
+void hex_image_free(hex_image *image);
+const hex_segment *hex_image_find(const hex_image *image, uint64_t address);
+
+uint8_t hex_index_build(hex_index *index, hex_map *map);
+uint8_t hex_index_open(hex_index *index, hex_map *map, const char *path);
+void hex_index_free(hex_index *index);
+uint8_t hex_index_load(const hex_index *index, hex_map *map, uint64_t start, uint64_t end, hex_image *image);
 
-uint32_t get_next_command(hex_string *h_str, FILE *file);
-uint8_t read_next_str(hex_string *h_str, FILE *file);
-uint8_t find_offset(hex_string *h_str, FILE *file, uint16_t offset);
+uint8_t elf_detect(const hex_map *map);
+uint8_t elf_image_load(hex_image *image, const hex_map *map, uint8_t *pc);
+
+void symbol_table_init(symbol_table *table);
+uint8_t symbol_table_load_elf(symbol_table *table, const hex_map *map);
+uint8_t symbol_table_load_nm(symbol_table *table, const hex_map *map);
+void symbol_table_free(symbol_table *table);
+const symbol *symbol_find(const symbol_table *table, uint64_t address);
+const symbol *symbol_at(symbol_table *table, uint64_t address);
+
+uint8_t out_open_fd(out_sink *out, int fd);
+uint8_t out_open_mem(out_sink *out, size_t size);
+uint8_t out_open_map(out_sink *out, const char *path);
+uint8_t out_reserve(out_sink *out, size_t len);
+uint8_t out_flush(out_sink *out);
+uint8_t out_close(out_sink *out);
+void out_write(out_sink *out, const char *str, size_t len);
+void out_puts(out_sink *out, const char *str);
+void out_hex(out_sink *out, uint64_t value, uint8_t digits);
+void out_dec(out_sink *out, uint64_t value);
+
+uint32_t disasm_serial(out_sink *out, const hex_segment *segment, size_t start, uint8_t pc,
+    uint8_t check_decoder);
+uint32_t disasm_range(out_sink *out, const hex_segment *segment, size_t start, size_t end, uint8_t pc,
+    uint8_t check_decoder);
+uint8_t disasm_collect_linear(const hex_segment *segment, size_t start, size_t end, uint8_t pc,
+    command_data **cmds, size_t *num_of_cmds);
+uint8_t disasm_collect_reachable(const hex_image *image, uint64_t entry, uint8_t pc, command_data **cmds,
+    size_t *num_of_cmds);
+uint32_t disasm_recursive(out_sink *out, const hex_image *image, uint64_t entry, uint8_t pc,
+    uint8_t check_decoder, uint8_t *err);
+uint32_t disasm_parallel(out_sink *out, const hex_segment *segment, size_t start, uint8_t pc,
+    uint8_t check_decoder, uint32_t num_of_threads);
 
 // bp - byte parse
-void bp_opcode(command_data* cd);
\ No newline at end of file
+void bp_opcode(command_data* cd);
+void bp_opcode_table(command_data* cd);
+uint32_t decode_table_check(uint8_t pc);
+
+uint8_t disasm_stream(out_sink *out, int fd, uint8_t raw, uint64_t base, uint8_t pc, uint8_t check_decoder,
+    uint32_t *mismatches);
+
+uint8_t cfg_build(cfg_graph *cfg, const command_data *cmds, size_t num_of_cmds);
+void cfg_free(cfg_graph *cfg);
+void cfg_write_dot(out_sink *out, const cfg_graph *cfg, const command_data *cmds);
+void cfg_write_json(out_sink *out, const cfg_graph *cfg, const command_data *cmds);
+
+// flags of disasm_annotated()
+#define DISASM_LABELS   0x01
+#define DISASM_PSEUDO   0x02
+
+uint32_t disasm_annotated(out_sink *out, const hex_segment *segment, size_t start, size_t end, uint8_t pc,
+    uint8_t check_decoder, uint8_t flags, symbol_table *symbols, uint8_t *err);
+uint32_t disasm_print_annotated(out_sink *out, const command_data *cmds, size_t num_of_cmds, uint8_t check_decoder,
+    uint8_t flags, symbol_table *symbols, uint8_t *err);
+
+// libdisasm batch API, disasm_init() once before anything else
+void disasm_init(void);
+// optional hot-word decode cache of the calling thread, 0 entries - off
+uint8_t decode_cache_enable(uint32_t num_of_entries);
+uint32_t decode_cache_size(void);
+void decode_cache_stats(uint64_t *hits, uint64_t *misses);
+size_t disasm_decode(const uint8_t *data, size_t size, uint64_t address, uint8_t pc,
+    command_data *cmds, size_t max_cmds, size_t *used);
+size_t disasm_format(const command_data *cd, char *buf, size_t size);
+void disasm_print(out_sink *out, const command_data *cmds, size_t num_of_cmds);
+
+uint8_t command_batch_init(command_batch *batch, size_t capacity);
+void command_batch_free(command_batch *batch);
+size_t disasm_decode_batch(const uint8_t *data, size_t size, uint64_t address, uint8_t pc,
+    command_batch *batch, size_t *used);
+void command_batch_get(const command_batch *batch, size_t i, command_data *cd);
+void disasm_print_batch(out_sink *out, const command_batch *batch);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,314 @@
+# RISC-V commands, one per line, in rv_op order. gen_opcodes turns this file into
+# risc_v_opcodes.h (enum rv_op) and risc_v_opcodes.inc (opcode_data[] and the
+# rv32/rv64/rv128 decode tables), the Makefile reruns it whenever the file changes.
+#
+# op      - rv_op name without op_
+# name    - mnemonic printed by the O format specifier
+# codec   - rv_codec_ function filling command_data, without rv_codec_
+# format  - rv_fmt_ operand listing, without rv_fmt_
+# mask    - bits of the command that identify it, - for commands no encoding decodes to
+# match   - value of those bits
+# isa     - widths the encoding decodes under: all or a comma list of 32, 64, 128
+#
+# Encodings of one width may overlap only if one mask has more bits, that one wins.
+#
+# op        name       codec     format                 mask        match       isa
+illegal     illegal    none      none                   -           -           -
+
+# RVC quadrant 0
+c_addi4spn  addi       ciw_4spn  rd_rs1_imm             0x0000e003  0x00000000  all
+c_fld       fld        cl_ld     frd_offset_rs1         0x0000e003  0x00002000  32,64
+c_lq        lq         cl_lq     rd_offset_rs1          0x0000e003  0x00002000  128
+c_lw        lw         cl_lw     rd_offset_rs1          0x0000e003  0x00004000  all
+c_flw       flw        cl_lw     frd_offset_rs1         0x0000e003  0x00006000  32
+c_ld        ld         cl_ld     rd_offset_rs1          0x0000e003  0x00006000  64,128
+c_fsd       fsd        cs_sd     frs2_offset_rs1        0x0000e003  0x0000a000  32,64
+c_sq        sq         cs_sq     rs2_offset_rs1         0x0000e003  0x0000a000  128
+c_sw        sw         cs_sw     rs2_offset_rs1         0x0000e003  0x0000c000  all
+c_fsw       fsw        cs_sw     frs2_offset_rs1        0x0000e003  0x0000e000  32
+c_sd        sd         cs_sd     rs2_offset_rs1         0x0000e003  0x0000e000  64,128
+
+# RVC quadrant 1
+c_nop       nop        ci_none   none                   0x0000ef83  0x00000001  all
+c_addi      addi       ci        rd_rs1_imm             0x0000e003  0x00000001  all
+c_jal       jal        cj_jal    rd_offset              0x0000e003  0x00002001  32
+c_addiw     addiw      ci        rd_rs1_imm             0x0000e003  0x00002001  64,128
+c_li        addi       ci_li     rd_rs1_imm             0x0000e003  0x00004001  all
+c_addi16sp  addi       ci_16sp   rd_rs1_imm             0x0000ef83  0x00006101  all
+c_lui       lui        ci_lui    rd_imm                 0x0000e003  0x00006001  all
+c_srli      srli       cb_sh6    rd_rs1_imm             0x0000ec03  0x00008001  all
+c_srai      srai       cb_sh6    rd_rs1_imm             0x0000ec03  0x00008401  all
+c_andi      andi       cb_imm    rd_rs1_imm             0x0000ec03  0x00008801  all
+c_sub       sub        cs        rd_rs1_rs2             0x0000fc63  0x00008c01  all
+c_xor       xor        cs        rd_rs1_rs2             0x0000fc63  0x00008c21  all
+c_or        or         cs        rd_rs1_rs2             0x0000fc63  0x00008c41  all
+c_and       and        cs        rd_rs1_rs2             0x0000fc63  0x00008c61  all
+c_subw      subw       cs        rd_rs1_rs2             0x0000fc63  0x00009c01  all
+c_addw      addw       cs        rd_rs1_rs2             0x0000fc63  0x00009c21  all
+c_j         j          cj        offset                 0x0000e003  0x0000a001  all
+c_beqz      beqz       cb        rs1_offset             0x0000e003  0x0000c001  all
+c_bnez      bnez       cb        rs1_offset             0x0000e003  0x0000e001  all
+
+# RVC quadrant 2
+c_slli      slli       ci_sh6    rd_rs1_imm             0x0000e003  0x00000002  all
+c_fldsp     fld        ci_ldsp   frd_offset_rs1         0x0000e003  0x00002002  32,64
+c_lqsp      lq         ci_lqsp   rd_offset_rs1          0x0000e003  0x00002002  128
+c_lwsp      lw         ci_lwsp   rd_offset_rs1          0x0000e003  0x00004002  all
+c_flwsp     flw        ci_lwsp   frd_offset_rs1         0x0000e003  0x00006002  32
+c_ldsp      ld         ci_ldsp   rd_offset_rs1          0x0000e003  0x00006002  64,128
+c_jr        jr         cr_jr     rs1                    0x0000f07f  0x00008002  all
+c_mv        mv         cr_mv     rd_rs1                 0x0000f003  0x00008002  all
+c_ebreak    ebreak     ci_none   none                   0x0000ffff  0x00009002  all
+c_jalr      jalr       cr_jalr   rd_rs1_offset          0x0000f07f  0x00009002  all
+c_add       add        cr        rd_rs1_rs2             0x0000f003  0x00009002  all
+c_fsdsp     fsd        css_sdsp  frs2_offset_rs1        0x0000e003  0x0000a002  32,64
+c_sqsp      sq         css_sqsp  rs2_offset_rs1         0x0000e003  0x0000a002  128
+c_swsp      sw         css_swsp  rs2_offset_rs1         0x0000e003  0x0000c002  all
+c_fswsp     fsw        css_swsp  frs2_offset_rs1        0x0000e003  0x0000e002  32
+c_sdsp      sd         css_sdsp  rs2_offset_rs1         0x0000e003  0x0000e002  64,128
+
+# RV32I
+lui         lui        u         rd_imm                 0x0000007f  0x00000037  all
+auipc       auipc      u         rd_offset              0x0000007f  0x00000017  all
+jal         jal        uj        rd_offset              0x0000007f  0x0000006f  all
+jalr        jalr       i         rd_rs1_offset          0x0000007f  0x00000067  all
+beq         beq        sb        rs1_rs2_offset         0x0000707f  0x00000063  all
+bne         bne        sb        rs1_rs2_offset         0x0000707f  0x00001063  all
+blt         blt        sb        rs1_rs2_offset         0x0000707f  0x00004063  all
+bge         bge        sb        rs1_rs2_offset         0x0000707f  0x00005063  all
+bltu        bltu       sb        rs1_rs2_offset         0x0000707f  0x00006063  all
+bgeu        bgeu       sb        rs1_rs2_offset         0x0000707f  0x00007063  all
+lb          lb         i         rd_offset_rs1          0x0000707f  0x00000003  all
+lh          lh         i         rd_offset_rs1          0x0000707f  0x00001003  all
+lw          lw         i         rd_offset_rs1          0x0000707f  0x00002003  all
+lbu         lbu        i         rd_offset_rs1          0x0000707f  0x00004003  all
+lhu         lhu        i         rd_offset_rs1          0x0000707f  0x00005003  all
+sb          sb         s         rs2_offset_rs1         0x0000707f  0x00000023  all
+sh          sh         s         rs2_offset_rs1         0x0000707f  0x00001023  all
+sw          sw         s         rs2_offset_rs1         0x0000707f  0x00002023  all
+addi        addi       i         rd_rs1_imm             0x0000707f  0x00000013  all
+slti        slti       i         rd_rs1_imm             0x0000707f  0x00002013  all
+sltiu       sltiu      i         rd_rs1_imm             0x0000707f  0x00003013  all
+xori        xori       i         rd_rs1_imm             0x0000707f  0x00004013  all
+ori         ori        i         rd_rs1_imm             0x0000707f  0x00006013  all
+andi        andi       i         rd_rs1_imm             0x0000707f  0x00007013  all
+slli        slli       i_sh7     rd_rs1_imm             0x0000707f  0x00001013  all
+srli        srli       i_sh7     rd_rs1_imm             0x4000707f  0x00005013  all
+srai        srai       i_sh7     rd_rs1_imm             0x4000707f  0x40005013  all
+add         add        r         rd_rs1_rs2             0xfe00707f  0x00000033  all
+sub         sub        r         rd_rs1_rs2             0xfe00707f  0x40000033  all
+sll         sll        r         rd_rs1_rs2             0xfe00707f  0x00001033  all
+slt         slt        r         rd_rs1_rs2             0xfe00707f  0x00002033  all
+sltu        sltu       r         rd_rs1_rs2             0xfe00707f  0x00003033  all
+xor         xor        r         rd_rs1_rs2             0xfe00707f  0x00004033  all
+srl         srl        r         rd_rs1_rs2             0xfe00707f  0x00005033  all
+sra         sra        r         rd_rs1_rs2             0xfe00707f  0x40005033  all
+or          or         r         rd_rs1_rs2             0xfe00707f  0x00006033  all
+and         and        r         rd_rs1_rs2             0xfe00707f  0x00007033  all
+fence       fence      r_f       pred_succ              0x0000707f  0x0000000f  all
+ecall       ecall      none      none                   0xfff0707f  0x00000073  all
+ebreak      ebreak     none      none                   0xfff0707f  0x00100073  all
+
+# RV64I
+lwu         lwu        i         rd_offset_rs1          0x0000707f  0x00006003  all
+ld          ld         i         rd_offset_rs1          0x0000707f  0x00003003  all
+sd          sd         s         rs2_offset_rs1         0x0000707f  0x00003023  all
+addiw       addiw      i         rd_rs1_imm             0x0000707f  0x0000001b  all
+slliw       slliw      i_sh5     rd_rs1_imm             0x0000707f  0x0000101b  all
+srliw       srliw      i_sh5     rd_rs1_imm             0x4000707f  0x0000501b  all
+sraiw       sraiw      i_sh5     rd_rs1_imm             0x4000707f  0x4000501b  all
+addw        addw       r         rd_rs1_rs2             0xfe00707f  0x0000003b  all
+subw        subw       r         rd_rs1_rs2             0xfe00707f  0x4000003b  all
+sllw        sllw       r         rd_rs1_rs2             0x0000707f  0x0000103b  all
+srlw        srlw       r         rd_rs1_rs2             0xfe00707f  0x0000503b  all
+sraw        sraw       r         rd_rs1_rs2             0xfe00707f  0x4000503b  all
+
+# Zifencei, Zicsr
+fence_i     fence.i    none      none                   0x0000007f  0x0000000f  all
+csrrw       csrrw      i_csr     rd_csr_rs1             0x0000707f  0x00001073  all
+csrrs       csrrs      i_csr     rd_csr_rs1             0x0000707f  0x00002073  all
+csrrc       csrrc      i_csr     rd_csr_rs1             0x0000707f  0x00003073  all
+csrrwi      csrrwi     i_csr     rd_csr_zimm            0x0000707f  0x00005073  all
+csrrsi      csrrsi     i_csr     rd_csr_zimm            0x0000707f  0x00006073  all
+csrrci      csrrci     i_csr     rd_csr_zimm            0x0000707f  0x00007073  all
+
+# RV32M, RV64M
+mul         mul        r         rd_rs1_rs2             0xfe00707f  0x02000033  all
+mulh        mulh       r         rd_rs1_rs2             0xfe00707f  0x02001033  all
+mulhsu      mulhsu     r         rd_rs1_rs2             0xfe00707f  0x02002033  all
+mulhu       mulhu      r         rd_rs1_rs2             0xfe00707f  0x02003033  all
+div         div        r         rd_rs1_rs2             0xfe00707f  0x02004033  all
+divu        divu       r         rd_rs1_rs2             0xfe00707f  0x02005033  all
+rem         rem        r         rd_rs1_rs2             0xfe00707f  0x02006033  all
+remu        remu       r         rd_rs1_rs2             0xfe00707f  0x02007033  all
+mulw        mulw       r         rd_rs1_rs2             0xfe00707f  0x0200003b  all
+divw        divw       r         rd_rs1_rs2             0x0000707f  0x0000403b  all
+divuw       divuw      r         rd_rs1_rs2             0xfe00707f  0x0200503b  all
+remw        remw       r         rd_rs1_rs2             0x0000707f  0x0000603b  all
+remuw       remuw      r         rd_rs1_rs2             0x0000707f  0x0000703b  all
+
+# RV32A, RV64A
+lr_w        lr.w       r_l       aqrl_rd_rs1            0xf800707f  0x1000202f  all
+sc_w        sc.w       r_a       aqrl_rd_rs2_rs1        0xf800707f  0x1800202f  all
+amoswap_w   amoswap.w  r_a       aqrl_rd_rs2_rs1        0xf800707f  0x0800202f  all
+amoadd_w    amoadd.w   r_a       aqrl_rd_rs2_rs1        0xf800707f  0x0000202f  all
+amoxor_w    amoxor.w   r_a       aqrl_rd_rs2_rs1        0xf800707f  0x2000202f  all
+amoand_w    amoand.w   r_a       aqrl_rd_rs2_rs1        0xf800707f  0x6000202f  all
+amoor_w     amoor.w    r_a       aqrl_rd_rs2_rs1        0xf800707f  0x4000202f  all
+amomin_w    amomin.w   r_a       aqrl_rd_rs2_rs1        0xf800707f  0x8000202f  all
+amomax_w    amomax.w   r_a       aqrl_rd_rs2_rs1        0xf800707f  0xa000202f  all
+amominu_w   amominu.w  r_a       aqrl_rd_rs2_rs1        0xf800707f  0xc000202f  all
+amomaxu_w   amomaxu.w  r_a       aqrl_rd_rs2_rs1        0xf800707f  0xe000202f  all
+lr_d        lr.d       r_l       aqrl_rd_rs1            0xf800707f  0x1000302f  all
+sc_d        sc.d       r_a       aqrl_rd_rs2_rs1        0xf800707f  0x1800302f  all
+amoswap_d   amoswap.d  r_a       aqrl_rd_rs2_rs1        0xf800707f  0x0800302f  all
+amoadd_d    amoadd.d   r_a       aqrl_rd_rs2_rs1        0xf800707f  0x0000302f  all
+amoxor_d    amoxor.d   r_a       aqrl_rd_rs2_rs1        0xf800707f  0x2000302f  all
+amoand_d    amoand.d   r_a       aqrl_rd_rs2_rs1        0xf800707f  0x6000302f  all
+amoor_d     amoor.d    r_a       aqrl_rd_rs2_rs1        0xf800707f  0x4000302f  all
+amomin_d    amomin.d   r_a       aqrl_rd_rs2_rs1        0xf800707f  0x8000302f  all
+amomax_d    amomax.d   r_a       aqrl_rd_rs2_rs1        0xf800707f  0xa000302f  all
+amominu_d   amominu.d  r_a       aqrl_rd_rs2_rs1        0xf800707f  0xc000302f  all
+amomaxu_d   amomaxu.d  r_a       aqrl_rd_rs2_rs1        0xf800707f  0xe000302f  all
+
+# RV32F, RV64F
+flw         flw        i         frd_offset_rs1         0x0000707f  0x00002007  all
+fsw         fsw        s         frs2_offset_rs1        0x0000707f  0x00002027  all
+fmadd_s     fmadd.s    r4_m      rm_frd_frs1_frs2_frs3  0x0600007f  0x00000043  all
+fmsub_s     fmsum.s    r4_m      rm_frd_frs1_frs2_frs3  0x0600007f  0x00000047  all
+fnmsub_s    fnmsub.s   r4_m      rm_frd_frs1_frs2_frs3  0x0600007f  0x0000004b  all
+fnmadd_s    fnmadd.s   r4_m      rm_frd_frs1_frs2_frs3  0x0600007f  0x0000004f  all
+fadd_s      fadd.s     r_m       rm_frd_frs1_frs2       0xfe00007f  0x00000053  all
+fsub_s      fsub.s     r_m       rm_frd_frs1_frs2       0xfe00007f  0x08000053  all
+fmul_s      fmul.s     r_m       rm_frd_frs1_frs2       0xfe00007f  0x10000053  all
+fdiv_s      fdiv.s     r_m       rm_frd_frs1_frs2       0xfe00007f  0x18000053  all
+fsqrt_s     fsqrt.s    r_m       rm_frd_frs1            0xfe00007f  0x58000053  all
+fsgnj_s     fsgnj.s    r         frd_frs1_frs2          0xfe00707f  0x20000053  all
+fsgnjn_s    fsgnjn.s   r         frd_frs1_frs2          0xfe00707f  0x20001053  all
+fsgnjx_s    fsgnjx.s   r         frd_frs1_frs2          0xfe00707f  0x20002053  all
+fmin_s      fmin.s     r         frd_frs1_frs2          0xfe00707f  0x28000053  all
+fmax_s      fmax.s     r         frd_frs1_frs2          0xfe00007f  0x28000053  all
+fcvt_w_s    fcvt.w.s   r_m       rm_rd_frs1             0xfff0007f  0xc0000053  all
+fcvt_wu_s   fcvt.wu.s  r_m       rm_rd_frs1             0xfff0007f  0xc0100053  all
+fmv_x_w     fmv.x.w    r         rd_frs1                0xfe00707f  0xe0000053  all
+feq_s       feq.s      r         rd_frs1_frs2           0xfe00707f  0xa0002053  all
+flt_s       flt.s      r         rd_frs1_frs2           0xfe00707f  0xa0001053  all
+fle_s       fle.s      r         rd_frs1_frs2           0xfe00707f  0xa0000053  all
+fclass_s    fclass.s   r         rd_frs1                0xfe00007f  0xe0000053  all
+fcvt_s_w    fcvt.s.w   r_m       rm_frd_rs1             0xfff0007f  0xd0000053  all
+fcvt_s_wu   fcvt.s.wu  r_m       rm_frd_rs1             0xfff0007f  0xd0100053  all
+fmv_w_x     fmv.w.x    r         frd_rs1                0xfe00007f  0xf0000053  all
+fcvt_l_s    fcvt.l.s   r_m       rm_rd_frs1             0xfff0007f  0xc0200053  all
+fcvt_lu_s   fcvt.lu.s  r_m       rm_rd_frs1             0xfff0007f  0xc0300053  all
+fcvt_s_l    fcvt.s.l   r_m       rm_frd_rs1             0xfff0007f  0xd0200053  all
+fcvt_s_lu   fcvt.s.lu  r_m       rm_frd_rs1             0xfff0007f  0xd0300053  all
+
+# RV32D, RV64D
+fld         fld        i         frd_offset_rs1         0x0000707f  0x00003007  all
+fsd         fsd        s         frs2_offset_rs1        0x0000707f  0x00003027  all
+fmadd_d     fmadd.d    r4_m      rm_frd_frs1_frs2_frs3  0x0600007f  0x02000043  all
+fmsub_d     fmsub.d    r4_m      rm_frd_frs1_frs2_frs3  0x0600007f  0x02000047  all
+fnmsub_d    fnmsub.d   r4_m      rm_frd_frs1_frs2_frs3  0x0600007f  0x0200004b  all
+fnmadd_d    fnmadd.d   r4_m      rm_frd_frs1_frs2_frs3  0x0600007f  0x0200004f  all
+fadd_d      fadd.d     r_m       rm_frd_frs1_frs2       0xfe00007f  0x02000053  all
+fsub_d      fsub.d     r_m       rm_frd_frs1_frs2       0xfe00007f  0x0a000053  all
+fmul_d      fmul.d     r_m       rm_frd_frs1_frs2       0xfe00007f  0x12000053  all
+fdiv_d      fdiv.d     r_m       rm_frd_frs1_frs2       0xfe00007f  0x1a000053  all
+fsqrt_d     fsqrt.d    r_m       rm_frd_frs1            0xfe00007f  0x5a000053  all
+fsgnj_d     fsgnj.d    r         frd_frs1_frs2          0xfe00707f  0x22000053  all
+fsgnjn_d    fsgnjn.d   r         frd_frs1_frs2          0xfe00707f  0x22001053  all
+fsgnjx_d    fsgnjx.d   r         frd_frs1_frs2          0xfe00707f  0x22002053  all
+fmin_d      fmin.d     r         frd_frs1_frs2          0xfe00707f  0x2a000053  all
+fmax_d      fmax.d     r         frd_frs1_frs2          0xfe00007f  0x2a000053  all
+fcvt_s_d    fcvt.s.d   r_m       rm_frd_frs1            0xfff0007f  0x40100053  all
+fcvt_d_s    fcvt.d.s   r_m       rm_frd_frs1            0xfff0007f  0x42000053  all
+feq_d       feq.d      r         rd_frs1_frs2           0xfe00707f  0xa2002053  all
+flt_d       flt.d      r         rd_frs1_frs2           0xfe00707f  0xa2001053  all
+fle_d       fle.d      r         rd_frs1_frs2           0xfe00707f  0xa2000053  all
+fclass_d    fclass.d   r         rd_frs1                0xfe00007f  0xe2000053  all
+fcvt_w_d    fcvt.w.d   r_m       rm_rd_frs1             0xfff0007f  0xc2000053  all
+fcvt_wu_d   fcvt.wu.d  r_m       rm_rd_frs1             0xfff0007f  0xc2100053  all
+fcvt_d_w    fcvt.d.w   r_m       rm_frd_rs1             0xfff0007f  0xd2000053  all
+fcvt_d_wu   fcvt.d.wu  r_m       rm_frd_rs1             0xfff0007f  0xd2100053  all
+fcvt_l_d    fcvt.l.d   r_m       rm_rd_frs1             0xfff0007f  0xc2200053  all
+fcvt_lu_d   fcvt.lu.d  r_m       rm_rd_frs1             0xfff0007f  0xc2300053  all
+fmv_x_d     fmv.x.d    r         rd_frs1                0xfe00707f  0xe2000053  all
+fcvt_d_l    fcvt.d.l   r_m       rm_frd_rs1             0xfff0007f  0xd2200053  all
+fcvt_d_lu   fcvt.d.lu  r_m       rm_frd_rs1             0xfff0007f  0xd2300053  all
+fmv_d_x     fmv.d.x    r         frd_rs1                0xfe00007f  0xf2000053  all
+
+# RV32Q, RV64Q
+flq         flq        i         frd_offset_rs1         0x0000707f  0x00004007  all
+fsq         fsq        s         frs2_offset_rs1        0x0000707f  0x00004027  all
+fmadd_q     fmadd.q    r4_m      rm_frd_frs1_frs2_frs3  0x0600007f  0x06000043  all
+fmsub_q     fmsub.q    r4_m      rm_frd_frs1_frs2_frs3  0x0600007f  0x04000047  all
+fnmsub_q    fnmsub.q   r4_m      rm_frd_frs1_frs2_frs3  0x0600007f  0x0400004b  all
+fnmadd_q    fnmadd.q   r4_m      rm_frd_frs1_frs2_frs3  0x0600007f  0x0400004f  all
+fadd_q      fadd.q     r_m       rm_frd_frs1_frs2       0xfe00007f  0x06000053  all
+fsub_q      fsub.q     r_m       rm_frd_frs1_frs2       0xfe00007f  0x0e000053  all
+fmul_q      fmul.q     r_m       rm_frd_frs1_frs2       0xfe00007f  0x16000053  all
+fdiv_q      fdiv.q     r_m       rm_frd_frs1_frs2       0xfe00007f  0x1e000053  all
+fsqrt_q     fsqrt.q    r_m       rm_frd_frs1            0xfe00007f  0x5e000053  all
+fsgnj_q     fsgnj.q    r         frd_frs1_frs2          0xfe00707f  0x26000053  all
+fsgnjn_q    fsgnjn.q   r         frd_frs1_frs2          0xfe00707f  0x26001053  all
+fsgnjx_q    fsgnjx.q   r         frd_frs1_frs2          0xfe00707f  0x26002053  all
+fmin_q      fmin.q     r         frd_frs1_frs2          0xfe00707f  0x2e000053  all
+fmax_q      fmax.q     r         frd_frs1_frs2          0xfe00007f  0x2e000053  all
+fcvt_s_q    fcvt.s.q   r_m       rm_frd_frs1            0xfff0007f  0x40300053  all
+fcvt_q_s    fcvt.q.s   r_m       rm_frd_frs1            0xfff0007f  0x46000053  all
+fcvt_d_q    fcvt.d.q   r_m       rm_frd_frs1            0xfff0007f  0x42300053  all
+fcvt_q_d    fcvt.q.d   r_m       rm_frd_frs1            0xfff0007f  0x46100053  all
+feq_q       feq.q      r         rd_frs1_frs2           0xfe00707f  0xa6002053  all
+flt_q       flt.q      r         rd_frs1_frs2           0xfe00707f  0xa6001053  all
+fle_q       fle.q      r         rd_frs1_frs2           0xfe00707f  0xa6000053  all
+fclass_q    fclass.q   r         rd_frs1                0xfe00007f  0xe6000053  all
+fcvt_w_q    fcvt.w.q   r_m       rm_rd_frs1             0xfff0007f  0xc6000053  all
+fcvt_wu_q   fcvt.wu.q  r_m       rm_rd_frs1             0xfff0007f  0xc6100053  all
+fcvt_q_w    fcvt.q.w   r_m       rm_frd_rs1             0xfff0007f  0xd6000053  all
+fcvt_q_wu   fcvt.q.wu  r_m       rm_frd_rs1             0xfff0007f  0xd6100053  all
+fcvt_l_q    fcvt.l.q   r_m       rm_rd_frs1             0xfff0007f  0xc6200053  all
+fcvt_lu_q   fcvt.lu.q  r_m       rm_rd_frs1             0xfff0007f  0xc6300053  all
+fcvt_q_l    fcvt.q.l   r_m       rm_frd_rs1             0xfff0007f  0xd6200053  all
+fcvt_q_lu   fcvt.q.lu  r_m       rm_frd_rs1             0xfff0007f  0xd6300053  all
+
+# Zfh
+flh         flh        i         frd_offset_rs1         0x0000707f  0x00001007  all
+fsh         fsh        s         frs2_offset_rs1        0x0000707f  0x00001027  all
+fmadd_h     fmadd.h    r4_m      rm_frd_frs1_frs2_frs3  0x0600007f  0x04000043  all
+fmsub_h     fmsub.h    r4_m      rm_frd_frs1_frs2_frs3  0x0600007f  0x06000047  all
+fnmsub_h    fnmsub.h   r4_m      rm_frd_frs1_frs2_frs3  0x0600007f  0x0600004b  all
+fnmadd_h    fnmadd.h   r4_m      rm_frd_frs1_frs2_frs3  0x0600007f  0x0600004f  all
+fadd_h      fadd.h     r_m       rm_frd_frs1_frs2       0xfe00007f  0x04000053  all
+fsub_h      fsub.h     r_m       rm_frd_frs1_frs2       0xfe00007f  0x0c000053  all
+fmul_h      fmul.h     r_m       rm_frd_frs1_frs2       0xfe00007f  0x14000053  all
+fdiv_h      fdiv.h     r_m       rm_frd_frs1_frs2       0xfe00007f  0x1c000053  all
+fsqrt_h     fsqrt.h    r_m       rm_frd_frs1            0xfe00007f  0x5c000053  all
+fsgnj_h     fsgnj.h    r         frd_frs1_frs2          0xfe00707f  0x24000053  all
+fsgnjn_h    fsgnjn.h   r         frd_frs1_frs2          0xfe00707f  0x24001053  all
+fsgnjx_h    fsgnjx.h   r         frd_frs1_frs2          0xfe00707f  0x24002053  all
+fmin_h      fmin.h     r         frd_frs1_frs2          0xfe00707f  0x2c000053  all
+fmax_h      fmax.h     r         frd_frs1_frs2          0xfe00007f  0x2c000053  all
+fcvt_s_h    fcvt.s.h   r_m       rm_frd_frs1            0xfff0007f  0x40200053  all
+fcvt_h_s    fcvt.h.s   r_m       rm_frd_frs1            0xfff0007f  0x44000053  all
+fcvt_d_h    fcvt.d.h   r_m       rm_frd_frs1            0xfff0007f  0x42200053  all
+fcvt_h_d    fcvt.h.d   r_m       rm_frd_frs1            0xfff0007f  0x44100053  all
+fcvt_q_h    fcvt.q.h   r_m       rm_frd_frs1            0xfff0007f  0x46200053  all
+fcvt_h_q    fcvt.h.q   r_m       rm_frd_frs1            0xfff0007f  0x44300053  all
+feq_h       feq.h      r         rd_frs1_frs2           0xfe00707f  0xa4002053  all
+flt_h       flt.h      r         rd_frs1_frs2           0xfe00707f  0xa4001053  all
+fle_h       fle.h      r         rd_frs1_frs2           0xfe00707f  0xa4000053  all
+fclass_h    fclass.h   r         rd_frs1                0xfe00007f  0xe4000053  all
+fcvt_w_h    fcvt.w.h   r_m       rm_rd_frs1             0xfff0007f  0xc4000053  all
+fcvt_wu_h   fcvt.wu.h  r_m       rm_rd_frs1             0xfff0007f  0xc4100053  all
+fmv_x_h     fmv.x.h    r         rd_frs1                0xfe00707f  0xe4000053  all
+fcvt_h_w    fcvt.h.w   r_m       rm_frd_rs1             0xfff0007f  0xd4000053  all
+fcvt_h_wu   fcvt.h.wu  r_m       rm_frd_rs1             0xfff0007f  0xd4100053  all
+fmv_h_x     fmv.h.x    r         frd_rs1                0xfe00007f  0xf4000053  all
+fcvt_l_h    fcvt.l.h   r_m       rm_rd_frs1             0xfff0007f  0xc4200053  all
+fcvt_lu_h   fcvt.lu.h  r_m       rm_rd_frs1             0xfff0007f  0xc4300053  all
+fcvt_h_l    fcvt.h.l   r_m       rm_frd_rs1             0xfff0007f  0xd4200053  all
+fcvt_h_lu   fcvt.h.lu  r_m       rm_frd_rs1             0xfff0007f  0xd4300053  all
+
+# Zawrs
+wrs_nto     wrs.nto    ci_none   none                   0xfff0707f  0x00d00073  all
+wrs_sto     wrs.sto    ci_none   none                   0xfff0707f  0x01d00073  all